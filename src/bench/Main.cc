@@ -0,0 +1,491 @@
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+#include <json/json.h>
+
+#include "src/utils/System.h"
+#include "src/utils/Options.h"
+#include "src/utils/InputStream.h"
+#include "src/core/Dimacs.h"
+#include "src/core/BinaryCnf.h"
+#include "src/simp/SimpSolver.h"
+#include "src/gen/Generators.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Benchmark runner:
+//
+// Every instance is solved in a child process with the CPU time and memory limits set by
+// 'limitTime()'/'limitMemory()', either by executing a solver binary (which must understand
+// '-verb', '-stats-json' and the exit codes 10/20, like 'minisat' and 'minisat_core') or by the
+// linked library. Up to '-jobs' instances run at the same time. The result, the resource usage of
+// the child and the statistics it wrote ('Solver::collectStats()') go into a JSON report.
+//
+// With '-suite', the instances are generated ('Generators.h') instead: directly into the solver
+// for the library, through a temporary DIMACS file for a solver binary. Each stresses one part of
+// the solver; the per-instance statistics show how its time divides into the phases (with
+// '-stats-timers').
+//
+// Two reports are compared by the number of solved instances, the PAR-2 score (the mean CPU time,
+// counting an unsolved instance as twice the time limit) and the propagation rate.
+
+
+struct Instance {
+    std::string path;
+    std::string name;       // Relative to the directory given on the command line.
+    std::string stats;      // Where the child writes its statistics.
+    int         suite;      // Index into 'suite' for a generated instance, -1 for a file.
+    pid_t       pid;
+    double      start;      // Wall-clock time at the start.
+    bool        killed;     // By the wall-clock limit.
+    Json::Value result;
+};
+
+
+static bool isInstance(const std::string& name)
+{
+    return name.find(".cnf") != std::string::npos || name.find(".bcnf") != std::string::npos;
+}
+
+
+// Adds the instances in 'path' (a file or a directory, searched recursively) in the order of their names:
+static void collectInstances(const std::string& path, const std::string& name, std::vector<Instance>& out)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+        fprintf(stderr, "ERROR! Could not open file: %s (%s)\n", path.c_str(), strerror(errno)), exit(1);
+
+    if (!S_ISDIR(st.st_mode)){
+        Instance inst;
+        inst.path = path;
+        inst.name  = name;
+        inst.suite = -1;
+        out.push_back(inst);
+        return; }
+
+    DIR* dir = opendir(path.c_str());
+    if (dir == NULL)
+        fprintf(stderr, "ERROR! Could not open directory: %s (%s)\n", path.c_str(), strerror(errno)), exit(1);
+    std::vector<std::string> entries;
+    for (struct dirent* e; (e = readdir(dir)) != NULL; )
+        if (e->d_name[0] != '.')
+            entries.push_back(e->d_name);
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+
+    for (const std::string& e : entries){
+        std::string sub = path + "/" + e;
+        if (stat(sub.c_str(), &st) == 0 && (S_ISDIR(st.st_mode) || isInstance(e)))
+            collectInstances(sub, name.empty() ? e : name + "/" + e, out);
+    }
+}
+
+
+//=================================================================================================
+// Suite of generated instances (named by the part of the solver they stress):
+
+
+static const char* suite[] = {
+    "propagate/counter-8x255",
+    "propagate/coloring-300-2.3",
+    "analyze/pigeonhole-9",
+    "analyze/parity-22",
+    "analyze/random-3sat-150-4.26",
+    "eliminate/random-3sat-100000-2.0",
+    "eliminate/coloring-2000-2.0",
+};
+
+template<class Solver>
+static void generateSuite(int i, Solver& S)
+{
+    switch (i){
+    case 0: gen_counter(S, 8, 255); break;                          // SAT: long implication chains
+    case 1: gen_coloring(S, 300, 2.3, 3, 1); break;                 // SAT
+    case 2: gen_pigeonhole(S, 9); break;                            // UNSAT
+    case 3: gen_parity(S, 22, 1, false); break;                     // UNSAT
+    case 4: gen_randomKSat(S, 150, 3, 4.26, 1); break;              // SAT
+    case 5: gen_randomKSat(S, 100000, 3, 2.0, 1); break;            // SAT: almost solved by elimination
+    case 6: gen_coloring(S, 2000, 2.0, 3, 1); break;                // SAT
+    }
+}
+
+
+//=================================================================================================
+// Child processes:
+
+
+enum { exit_out_of_memory = 3 };   // From a library child that ran out of memory.
+
+static Solver* solver;
+static void SIGXCPU_interrupt(int) { solver->interrupt(); }
+
+// Solves the instance with the linked library. Does not return.
+static void runLibrary(const Instance& inst)
+{
+    try {
+        SimpSolver S;
+        S.verbosity = 0;
+        solver = &S;
+        sigTerm(SIGXCPU_interrupt);
+
+        if (inst.suite >= 0)
+            generateSuite(inst.suite, S);
+        else if (!parse_BinaryCnf(inst.path.c_str(), S)){
+            InputStream in;
+            if (!in.open(inst.path.c_str(), false))
+                _exit(1);
+            parse_DIMACS(in, S);
+            in.close(); }
+
+        S.eliminate(!S.use_inprocessing);
+        vec<Lit>   dummy;
+        lbool ret = S.okay() ? S.solveLimited(dummy) : l_False;
+
+        SolverStats stats;
+        S.collectStats(stats);
+        stats.writeJson(inst.stats.c_str());
+        _exit(ret == l_True ? 10 : ret == l_False ? 20 : 0);
+    } catch (OutOfMemoryException&){
+        _exit(exit_out_of_memory);
+    }
+}
+
+
+static pid_t start(Instance& inst, const char* solver_path, const std::vector<std::string>& solver_args,
+                   int cpu_lim, int mem_lim)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    // In the child: limits are inherited by a solver binary started by 'execv()'.
+    if (cpu_lim != 0) limitTime(cpu_lim);
+    if (mem_lim != 0) limitMemory(mem_lim);
+    int null = ::open("/dev/null", O_WRONLY);
+    if (null >= 0){ dup2(null, 1); dup2(null, 2); }
+
+    if (solver_path == NULL)
+        runLibrary(inst);
+
+    std::string              stats_opt = "-stats-json=" + inst.stats;
+    std::vector<const char*> argv;
+    argv.push_back(solver_path);
+    argv.push_back("-verb=0");
+    argv.push_back(stats_opt.c_str());
+    for (const std::string& a : solver_args) argv.push_back(a.c_str());
+    argv.push_back(inst.path.c_str());
+    argv.push_back(NULL);
+    execv(solver_path, (char* const*)&argv[0]);
+    _exit(127);
+}
+
+
+// Fills in 'inst.result' from the exit status and resource usage of its child:
+static void finish(Instance& inst, int status, const struct rusage& ru, bool library, int cpu_lim, int mem_lim)
+{
+    Json::Value& r   = inst.result;
+    double       cpu = ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1e6 + ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1e6;
+    double       mem = ru.ru_maxrss / 1024.0;
+    r["name"]      = inst.name;
+    r["cpu"]       = cpu;
+    r["wall"]      = wallTime() - inst.start;
+    r["memory_mb"] = mem;
+
+    int code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+    if (library && code == exit_out_of_memory) code = 0, mem = mem_lim;
+    r["result"] = code == 10 ? "SAT" : code == 20 ? "UNSAT" : code == 0 || inst.killed ? "UNKNOWN" : "ERROR";
+    if (code == 0 || code == -1){
+        // (an unsolved instance hit a limit, unless the solver failed on its own)
+        r["reason"] = inst.killed                                   ? "wall-limit"
+                    : cpu_lim != 0 && cpu >= cpu_lim                ? "cpu-limit"
+                    : mem_lim != 0 && mem >= 0.9 * mem_lim          ? "memory-limit"
+                    : WIFSIGNALED(status)                           ? strsignal(WTERMSIG(status))
+                    :                                                 "indeterminate"; }
+    else if (code != 10 && code != 20)
+        r["reason"] = code == 127 ? "could not execute the solver" : "exit code " + std::to_string(code);
+
+    std::ifstream           in(inst.stats);
+    Json::CharReaderBuilder builder;
+    Json::Value             stats;
+    std::string             errors;
+    if (in && Json::parseFromStream(builder, in, &stats, &errors))
+        r["stats"] = stats;
+    unlink(inst.stats.c_str());
+}
+
+
+//=================================================================================================
+// Reports:
+
+
+static bool solved(const Json::Value& r) { return r["result"] == "SAT" || r["result"] == "UNSAT"; }
+
+static double par2(const Json::Value& r, double cpu_lim) { return solved(r) ? r["cpu"].asDouble() : 2 * cpu_lim; }
+
+
+static Json::Value summarize(const Json::Value& instances, double cpu_lim)
+{
+    Json::Value s(Json::objectValue);
+    int         sat = 0, unsat = 0, errors = 0;
+    double      score = 0, cpu = 0, props = 0, props_cpu = 0;
+    double      propagate = 0, analyze = 0, eliminate = 0;   // (only measured with '-stats-timers')
+    for (const Json::Value& r : instances){
+        sat    += r["result"] == "SAT";
+        unsat  += r["result"] == "UNSAT";
+        errors += r["result"] == "ERROR";
+        score  += par2(r, cpu_lim);
+        cpu    += r["cpu"].asDouble();
+        if (r["stats"].isObject()){
+            props     += r["stats"]["search"]["propagations"].asDouble();
+            props_cpu += r["cpu"].asDouble();
+            propagate += r["stats"]["time"]["propagate"]["wall"].asDouble();
+            analyze   += r["stats"]["time"]["analyze"]["wall"].asDouble();
+            eliminate += r["stats"]["time"]["eliminate"]["wall"].asDouble(); }
+    }
+    s["instances"]            = instances.size();
+    s["solved"]               = sat + unsat;
+    s["sat"]                  = sat;
+    s["unsat"]                = unsat;
+    s["errors"]               = errors;
+    s["par2"]                 = instances.size() > 0 ? score / instances.size() : 0;
+    s["cpu"]                  = cpu;
+    s["propagations_per_sec"] = props_cpu > 0 ? props / props_cpu : 0;
+    s["time_propagate"]       = propagate;
+    s["time_analyze"]         = analyze;
+    s["time_eliminate"]       = eliminate;
+    return s;
+}
+
+
+static bool readReport(const char* path, Json::Value& report)
+{
+    std::ifstream           in(path);
+    Json::CharReaderBuilder builder;
+    std::string             errors;
+    return in && Json::parseFromStream(builder, in, &report, &errors) && report["instances"].isArray();
+}
+
+
+static void compareRow(const char* name, double a, double b)
+{
+    printf("%-24s %14.2f %14.2f", name, a, b);
+    if (a != 0) printf("   %+7.1f %%", (b - a) * 100 / a);
+    printf("\n");
+}
+
+
+// Prints the comparison of the reports 'a' (the baseline) and 'b'. Returns TRUE if 'b' is a
+// regression: fewer solved instances, contradicting results, or a PAR-2 score or propagation rate
+// more than 'tolerance' percent worse. Time differences of less than 'min_time' seconds (for the
+// PAR-2 score: in total) are timer noise and never count, nor are the propagation rates of runs
+// shorter than that compared.
+static bool compare(const Json::Value& a, const Json::Value& b, double tolerance, double slowdown, double min_time)
+{
+    const Json::Value& sa = a["summary"];
+    const Json::Value& sb = b["summary"];
+    printf("%-24s %14s %14s   (B-A)/A\n", "", "A", "B");
+    compareRow("instances",            sa["instances"].asDouble(), sb["instances"].asDouble());
+    compareRow("solved",               sa["solved"].asDouble(),    sb["solved"].asDouble());
+    compareRow("  SAT",                sa["sat"].asDouble(),       sb["sat"].asDouble());
+    compareRow("  UNSAT",              sa["unsat"].asDouble(),     sb["unsat"].asDouble());
+    compareRow("errors",               sa["errors"].asDouble(),    sb["errors"].asDouble());
+    compareRow("PAR-2 (s)",            sa["par2"].asDouble(),      sb["par2"].asDouble());
+    compareRow("propagations/sec",     sa["propagations_per_sec"].asDouble(), sb["propagations_per_sec"].asDouble());
+    static const char* phases[][2] = { { "time_propagate", "propagate (s)" }, { "time_analyze", "analyze (s)" }, { "time_eliminate", "eliminate (s)" } };
+    for (auto& p : phases)
+        if (sa[p[0]].asDouble() != 0 || sb[p[0]].asDouble() != 0)
+            compareRow(p[1], sa[p[0]].asDouble(), sb[p[0]].asDouble());
+
+    // Per instance (matched by name):
+    std::map<std::string, const Json::Value*> by_name;
+    for (const Json::Value& r : a["instances"])
+        by_name[r["name"].asString()] = &r;
+
+    bool regression = sb["solved"].asInt() < sa["solved"].asInt()
+                   || sb["errors"].asInt() > sa["errors"].asInt()
+                   || (sb["par2"].asDouble() > sa["par2"].asDouble() * (1 + tolerance / 100)
+                       && (sb["par2"].asDouble() - sa["par2"].asDouble()) * sb["instances"].asDouble() >= min_time)
+                   || (sb["propagations_per_sec"].asDouble() < sa["propagations_per_sec"].asDouble() * (1 - tolerance / 100)
+                       && sa["cpu"].asDouble() >= min_time && sb["cpu"].asDouble() >= min_time);
+    bool header = false;
+    for (const Json::Value& rb : b["instances"]){
+        auto it = by_name.find(rb["name"].asString());
+        if (it == by_name.end()) continue;
+        const Json::Value& ra   = *it->second;
+        const char*        what = NULL;
+        if (solved(ra) && solved(rb) && ra["result"] != rb["result"]){
+            what = "CONTRADICTING RESULTS";
+            regression = true;
+        }else if (solved(ra) && !solved(rb))
+            what = "only solved by A";
+        else if (!solved(ra) && solved(rb))
+            what = "only solved by B";
+        else if (solved(ra) && solved(rb) && rb["cpu"].asDouble() - ra["cpu"].asDouble() >= min_time
+                 && rb["cpu"].asDouble() > slowdown * ra["cpu"].asDouble())
+            what = "slower";
+        if (what == NULL) continue;
+
+        if (!header){
+            printf("\n%-40s %10s %10s  %-10s %-10s\n", "instance", "A (s)", "B (s)", "A", "B");
+            header = true; }
+        printf("%-40s %10.2f %10.2f  %-10s %-10s %s\n", rb["name"].asCString(), ra["cpu"].asDouble(), rb["cpu"].asDouble(),
+               ra["result"].asCString(), rb["result"].asCString(), what);
+    }
+    printf("\n%s\n", regression ? "REGRESSION" : "OK");
+    return regression;
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <cnf-file-or-directory>...\n"
+                  "       %s [options] -suite\n"
+                  "       %s -compare <baseline-report> <report>\n\n"
+                  "  Runs a solver over the instances (directories are searched for *.cnf* and *.bcnf* files) or the\n"
+                  "  built-in suite of generated instances and writes a JSON report, or compares two reports. The exit\n"
+                  "  code of a comparison is 1 for a regression.\n");
+
+    StringOption solver_path("MAIN", "solver",   "Solver binary to run (e.g. minisat_core); if not given, the linked library (SimpSolver) is used.");
+    StringOption solver_opts("MAIN", "solver-args", "Extra arguments for the solver binary (separated by spaces).", "");
+    StringOption report_path("MAIN", "report",   "File for the JSON report.", "bench.json");
+    IntOption    cpu_lim    ("MAIN", "cpu-lim",  "Limit on CPU time per instance in seconds.", 60, IntRange(1, INT32_MAX));
+    IntOption    mem_lim    ("MAIN", "mem-lim",  "Limit on memory usage per instance in megabytes (0 = none).", 4096, IntRange(0, INT32_MAX));
+    IntOption    wall_lim   ("MAIN", "wall-lim", "Limit on wall-clock time per instance in seconds (0 = twice the CPU limit plus 10).", 0, IntRange(0, INT32_MAX));
+    IntOption    jobs       ("MAIN", "jobs",     "Number of instances solved at the same time.", 1, IntRange(1, 1024));
+    BoolOption   do_compare ("MAIN", "compare",  "Compare two reports instead of running the solver.", false);
+    BoolOption   do_suite   ("MAIN", "suite",    "Run the built-in suite of generated instances.", false);
+    DoubleOption tolerance  ("MAIN", "tolerance","Relative loss (in percent) of the PAR-2 score or propagation rate counted as a regression.", 5, DoubleRange(0, true, HUGE_VAL, false));
+    DoubleOption slowdown   ("MAIN", "slowdown", "List the instances that got slower by more than this factor.", 2, DoubleRange(1, true, HUGE_VAL, false));
+    DoubleOption min_time   ("MAIN", "min-time", "Time differences (in seconds) below which a comparison sees no change.", 1, DoubleRange(0, true, HUGE_VAL, false));
+    IntOption    verb       ("MAIN", "verb",     "Verbosity level (0=silent, 1=some).", 1, IntRange(0, 1));
+
+    parseOptions(argc, argv, true);
+
+    if (do_compare){
+        Json::Value a, b;
+        if (argc != 3)
+            printUsageAndExit(argc, argv);
+        if (!readReport(argv[1], a)) fprintf(stderr, "ERROR! Not a benchmark report: %s\n", argv[1]), exit(2);
+        if (!readReport(argv[2], b)) fprintf(stderr, "ERROR! Not a benchmark report: %s\n", argv[2]), exit(2);
+        return compare(a, b, tolerance, slowdown, min_time) ? 1 : 0;
+    }
+    if (do_suite ? argc != 1 : argc < 2)
+        printUsageAndExit(argc, argv);
+
+    std::vector<Instance> instances;
+    for (int i = 0; do_suite && i < (int)(sizeof(suite) / sizeof(*suite)); i++){
+        Instance inst;
+        inst.name  = suite[i];
+        inst.suite = i;
+        instances.push_back(inst); }
+    for (int i = 1; i < argc; i++){
+        struct stat st;
+        bool        is_dir = stat(argv[i], &st) == 0 && S_ISDIR(st.st_mode);
+        collectInstances(argv[i], is_dir ? "" : argv[i], instances); }
+
+    std::vector<std::string> solver_args;
+    for (const char* p = solver_opts; *p != '\0'; ){
+        while (*p == ' ') p++;
+        const char* q = p;
+        while (*q != ' ' && *q != '\0') q++;
+        if (q > p) solver_args.push_back(std::string(p, q));
+        p = q; }
+
+    char tmp_dir[] = "/tmp/minisat_bench.XXXXXX";
+    if (mkdtemp(tmp_dir) == NULL)
+        fprintf(stderr, "ERROR! Could not create a temporary directory (%s)\n", strerror(errno)), exit(1);
+    for (size_t i = 0; i < instances.size(); i++)
+        instances[i].stats = std::string(tmp_dir) + "/" + std::to_string(i) + ".json";
+
+    // A solver binary gets the generated instances as files:
+    for (size_t i = 0; solver_path != NULL && i < instances.size(); i++)
+        if (instances[i].suite >= 0){
+            Solver S;
+            S.verbosity = 0;
+            generateSuite(instances[i].suite, S);
+            instances[i].path = std::string(tmp_dir) + "/" + std::to_string(i) + ".cnf";
+            S.toDimacs(instances[i].path.c_str()); }
+
+    // Run the instances, 'jobs' at a time:
+    double   wall_limit = wall_lim != 0 ? (double)wall_lim : 2.0 * cpu_lim + 10;
+    size_t   next = 0, done = 0;
+    int      running = 0;
+    while (done < instances.size()){
+        while (running < jobs && next < instances.size()){
+            Instance& inst = instances[next++];
+            inst.start  = wallTime();
+            inst.killed = false;
+            inst.pid    = start(inst, solver_path, solver_args, cpu_lim, mem_lim);
+            if (inst.pid < 0)
+                fprintf(stderr, "ERROR! Could not start a process (%s)\n", strerror(errno)), exit(1);
+            running++; }
+
+        int           status;
+        struct rusage ru;
+        pid_t         pid = wait4(-1, &status, WNOHANG, &ru);
+        if (pid <= 0){
+            // Enforce the wall-clock limit on the running instances:
+            for (size_t i = 0; i < next; i++)
+                if (instances[i].pid > 0 && !instances[i].killed && wallTime() - instances[i].start > wall_limit){
+                    kill(instances[i].pid, SIGKILL);
+                    instances[i].killed = true; }
+            usleep(10000);
+            continue; }
+
+        for (size_t i = 0; i < next; i++)
+            if (instances[i].pid == pid){
+                Instance& inst = instances[i];
+                finish(inst, status, ru, solver_path == NULL, cpu_lim, mem_lim);
+                if (inst.suite >= 0 && solver_path != NULL)
+                    unlink(inst.path.c_str());
+                inst.pid = 0;
+                running--;
+                done++;
+                if (verb > 0)
+                    printf("[%zu/%zu] %-50s %-7s %8.2f s\n", done, instances.size(), inst.name.c_str(),
+                           inst.result["result"].asCString(), inst.result["cpu"].asDouble());
+                break; }
+    }
+    rmdir(tmp_dir);
+
+    Json::Value report(Json::objectValue);
+    Json::Value results(Json::arrayValue);
+    for (const Instance& inst : instances)
+        results.append(inst.result);
+    report["solver"]   = solver_path ? (const char*)solver_path : "library";
+    report["cpu_lim"]  = (int)cpu_lim;
+    report["mem_lim"]  = (int)mem_lim;
+    report["summary"]  = summarize(results, cpu_lim);
+    report["instances"] = results;
+
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    std::ofstream out(report_path);
+    out << Json::writeString(builder, report) << "\n";
+    if (!out)
+        fprintf(stderr, "ERROR! Could not write file: %s\n", (const char*)report_path), exit(1);
+
+    if (verb > 0){
+        const Json::Value& s = report["summary"];
+        printf("solved %d of %d (%d SAT, %d UNSAT, %d errors), PAR-2 %.2f s, %.0f propagations/sec\n",
+               s["solved"].asInt(), s["instances"].asInt(), s["sat"].asInt(), s["unsat"].asInt(), s["errors"].asInt(),
+               s["par2"].asDouble(), s["propagations_per_sec"].asDouble()); }
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "src/utils/System.h"
+#include "src/utils/Options.h"
+#include "src/utils/InputStream.h"
+#include "src/core/Dimacs.h"
+#include "src/core/BinaryCnf.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Conversion between DIMACS and the binary CNF format (see 'BinaryCnf.h'):
+
+
+// Reads (possibly compressed) DIMACS into 'lits'/'offsets'. Returns the number of variables.
+static int readDimacs(const char* path, bool bg_read, vec<Lit>& lits, vec<int>& offsets)
+{
+    InputStream in;
+    if (!(path == NULL ? in.open(dup(0), bg_read) : in.open(path, bg_read)))
+        fprintf(stderr, "ERROR! Could not open file: %s\n", path == NULL ? "<stdin>" : path), exit(1);
+
+    // The whole text is tokenized at once, which keeps the header and the clauses exactly as given:
+    vec<char> text;
+    for (int n = 0;; ){
+        text.growTo(n + 1024*1024);
+        int len = in.read((unsigned char*)&text[n], text.size() - n);
+        if (len == 0){ text.shrink(text.size() - n); break; }
+        n += len;
+    }
+
+    DimacsChunk chunk;
+    chunk.begin = text.size() > 0 ? &text[0] : NULL;
+    chunk.end   = chunk.begin + text.size();
+    tokenizeDIMACS(chunk);
+
+    int vars = chunk.vars > 0 ? chunk.vars : 0;
+    lits.clear(); offsets.clear();
+    offsets.push(0);
+    for (int i = 0; i < chunk.tokens.size(); i++){
+        int parsed_lit = chunk.tokens[i];
+        if (parsed_lit == dimacs_xor)
+            fprintf(stderr, "ERROR! XOR constraints can not be converted\n"), exit(1);
+        else if (parsed_lit == 0)
+            offsets.push(lits.size());
+        else{
+            int var = abs(parsed_lit)-1;
+            if (var >= vars) vars = var + 1;
+            lits.push( (parsed_lit > 0) ? mkLit(var) : ~mkLit(var) );
+        }
+    }
+    if (lits.size() > offsets.last())
+        fprintf(stderr, "PARSE ERROR! Unexpected end of file\n"), exit(3);
+    if (chunk.clauses >= 0 && chunk.clauses != offsets.size() - 1)
+        fprintf(stderr, "WARNING! DIMACS header mismatch: %d clauses declared, %d found\n", chunk.clauses, offsets.size() - 1);
+    return vars;
+}
+
+
+static void writeDimacs(FILE* f, int vars, const vec<Lit>& lits, const vec<int>& offsets)
+{
+    fprintf(f, "p cnf %d %d\n", vars, offsets.size() - 1);
+    for (int i = 0; i + 1 < offsets.size(); i++){
+        for (int j = offsets[i]; j < offsets[i+1]; j++)
+            fprintf(f, "%s%d ", sign(lits[j]) ? "-" : "", var(lits[j])+1);
+        fprintf(f, "0\n");
+    }
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <input-file> <output-file>\n\n"
+                  "  Converts DIMACS (plain or compressed) to binary CNF and binary CNF to DIMACS.\n");
+
+    StringOption to     ("MAIN", "to",      "Output format: 'auto' (the other format), 'bcnf' or 'dimacs'.", "auto");
+    BoolOption   varint ("MAIN", "varint",  "Use the compact varint encoding for binary output.", false);
+    BoolOption   bg_read("MAIN", "bg-read", "Read and decompress input in a background thread.", true);
+    IntOption    verb   ("MAIN", "verb",    "Verbosity level (0=silent, 1=some).", 1, IntRange(0, 1));
+
+    parseOptions(argc, argv, true);
+    if (argc != 3)
+        printUsageAndExit(argc, argv);
+
+    const char* format = to;
+    if (strcmp(format, "auto") != 0 && strcmp(format, "bcnf") != 0 && strcmp(format, "dimacs") != 0)
+        fprintf(stderr, "ERROR! Unknown output format: %s\n", format), exit(1);
+
+    double   initial_time = cpuTime();
+    vec<Lit> lits;
+    vec<int> offsets;
+    int      vars;
+    bool     from_binary;
+
+    const char*     in_path = strcmp(argv[1], "-") == 0 ? NULL : argv[1];
+    BinaryCnfReader bin;
+    if ((from_binary = in_path != NULL && bin.open(in_path))){
+        vars = bin.vars();
+        bin.decode(lits, offsets);
+    }else
+        vars = readDimacs(in_path, bg_read, lits, offsets);
+
+    bool to_binary = strcmp(format, "auto") == 0 ? !from_binary : strcmp(format, "bcnf") == 0;
+
+    FILE* out = strcmp(argv[2], "-") == 0 ? stdout : fopen(argv[2], "wb");
+    if (out == NULL)
+        fprintf(stderr, "ERROR! Could not open file: %s\n", argv[2]), exit(1);
+    if (to_binary)
+        writeBinaryCnf(out, vars, lits, offsets, varint);
+    else
+        writeDimacs(out, vars, lits, offsets);
+    if (out != stdout && fclose(out) != 0)
+        fprintf(stderr, "ERROR! Could not write file: %s (%s)\n", argv[2], strerror(errno)), exit(1);
+
+    if (verb > 0)
+        fprintf(stderr, "c converted %d variables, %d clauses, %d literals (%s -> %s) in %.2f s\n",
+                vars, offsets.size() - 1, lits.size(), from_binary ? "bcnf" : "dimacs", to_binary ? "bcnf" : "dimacs",
+                cpuTime() - initial_time);
+    return 0;
+}
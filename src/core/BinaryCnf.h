@@ -0,0 +1,238 @@
+#ifndef Minisat_BinaryCnf_h
+#define Minisat_BinaryCnf_h
+
+#include <stdio.h>
+#include <string.h>
+
+#include "src/mtl/IntTypes.h"
+#include "src/utils/MappedFile.h"
+#include "src/core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Binary CNF format:
+//
+// All numbers are little-endian. The file starts with a 'BinaryCnfHeader', followed by the
+// clauses in one of two encodings:
+//
+//   fixed:  'clauses + 1' uint32 offsets (the first is 0, the last is 'literals'), then 'literals'
+//           uint32 literals. Clause 'i' consists of the literals 'offsets[i]' to 'offsets[i+1]-1'.
+//   varint: for each clause, its size followed by its literals, all as LEB128 varints.
+//
+// Literals are stored as '2*var + sign' with 0-based variables (i.e. the value of 'toInt(Lit)').
+// The fixed encoding can be loaded straight from a memory mapping; the varint encoding is about
+// half the size. Clauses are stored exactly as given (order, duplicates, tautologies and empty
+// clauses are preserved), so conversion from and to DIMACS is lossless apart from comments and
+// formatting.
+
+
+struct BinaryCnfHeader {
+    char     magic[8];   // "MSATBCNF"
+    uint32_t version;    // 1
+    uint32_t encoding;   // 'bcnf_fixed' or 'bcnf_varint'.
+    uint32_t vars;
+    uint32_t reserved;   // 0
+    uint64_t clauses;
+    uint64_t literals;
+};
+
+enum { bcnf_fixed = 0, bcnf_varint = 1 };
+
+static const char bcnf_magic[8] = { 'M', 'S', 'A', 'T', 'B', 'C', 'N', 'F' };
+
+static inline bool isBinaryCnf(const char* data, uint64_t size) {
+    return size >= sizeof(BinaryCnfHeader) && memcmp(data, bcnf_magic, sizeof(bcnf_magic)) == 0; }
+
+
+//-------------------------------------------------------------------------------------------------
+// Writing:
+
+
+static inline void bcnfPut32(FILE* f, uint32_t x) {
+    unsigned char b[4] = { (unsigned char)x, (unsigned char)(x >> 8), (unsigned char)(x >> 16), (unsigned char)(x >> 24) };
+    fwrite(b, 1, 4, f); }
+
+static inline void bcnfPut64(FILE* f, uint64_t x) {
+    bcnfPut32(f, (uint32_t)x); bcnfPut32(f, (uint32_t)(x >> 32)); }
+
+static inline void bcnfPutVarint(FILE* f, uint32_t x) {
+    while (x >= 0x80){
+        putc((int)(x & 0x7f) | 0x80, f);
+        x >>= 7; }
+    putc((int)x, f); }
+
+
+// Writes the clauses given as in 'Solver::addClauses()' (clause 'i' is 'lits[offsets[i]]' up to
+// 'lits[offsets[i+1]-1]') over the variables '0 .. vars-1'.
+static inline void writeBinaryCnf(FILE* f, int vars, const vec<Lit>& lits, const vec<int>& offsets, bool varint = false) {
+    int clauses = offsets.size() > 0 ? offsets.size() - 1 : 0;
+    int base    = clauses > 0 ? offsets[0] : 0;
+    int n_lits  = clauses > 0 ? offsets[clauses] - base : 0;
+
+    fwrite(bcnf_magic, 1, sizeof(bcnf_magic), f);
+    bcnfPut32(f, 1);
+    bcnfPut32(f, varint ? bcnf_varint : bcnf_fixed);
+    bcnfPut32(f, vars);
+    bcnfPut32(f, 0);
+    bcnfPut64(f, clauses);
+    bcnfPut64(f, n_lits);
+
+    if (varint){
+        for (int i = 0; i < clauses; i++){
+            bcnfPutVarint(f, offsets[i+1] - offsets[i]);
+            for (int j = offsets[i]; j < offsets[i+1]; j++)
+                bcnfPutVarint(f, toInt(lits[j])); }
+    }else{
+        for (int i = 0; i <= clauses; i++)
+            bcnfPut32(f, clauses > 0 ? offsets[i] - base : 0);
+        for (int j = 0; j < n_lits; j++)
+            bcnfPut32(f, toInt(lits[base + j]));
+    }
+}
+
+
+//-------------------------------------------------------------------------------------------------
+// Reading:
+
+
+class BinaryCnfReader {
+    MappedFile             file;
+    const BinaryCnfHeader* hdr;
+    const unsigned char*   body;
+    uint64_t               body_size;
+
+    static uint32_t get32(const unsigned char* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+    static uint64_t get64(const unsigned char* p) {
+        return (uint64_t)get32(p) | ((uint64_t)get32(p + 4) << 32); }
+
+    static void error(const char* msg) {
+        fprintf(stderr, "PARSE ERROR! Binary CNF: %s\n", msg), exit(3); }
+
+public:
+    BinaryCnfReader() : hdr(NULL), body(NULL), body_size(0) {}
+
+    // Returns FALSE if 'path' could not be mapped or is not a binary CNF file. A binary CNF file
+    // with an inconsistent header is reported as a parse error.
+    bool open(const char* path) {
+        if (!file.open(path) || !isBinaryCnf(file.data(), file.size()))
+            return false;
+        hdr       = (const BinaryCnfHeader*)file.data();
+        body      = (const unsigned char*)file.data() + sizeof(BinaryCnfHeader);
+        body_size = file.size() - sizeof(BinaryCnfHeader);
+
+        const unsigned char* h = (const unsigned char*)file.data();
+        if (get32(h + 8) != 1)                                     error("unsupported version");
+        if (encoding() != bcnf_fixed && encoding() != bcnf_varint) error("unknown encoding");
+        if (clauses() >= INT32_MAX || literals() >= INT32_MAX)     error("too many clauses or literals");
+        if (get32(h + 16) > (uint32_t)(INT32_MAX / 2))             error("too many variables");
+        if (encoding() == bcnf_fixed && body_size != 4 * (clauses() + 1 + literals()))
+            error("unexpected file size");
+        return true; }
+
+    uint32_t encoding() const { return get32((const unsigned char*)hdr + 12); }
+    int      vars    () const { return (int)get32((const unsigned char*)hdr + 16); }
+    uint64_t clauses () const { return get64((const unsigned char*)hdr + 24); }
+    uint64_t literals() const { return get64((const unsigned char*)hdr + 32); }
+
+    // Direct access to the arrays of the fixed encoding on a little-endian host (NULL otherwise).
+    // The arrays are checked for consistency first.
+    const int* mappedOffsets() {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        if (encoding() != bcnf_fixed) return NULL;
+        const int* offsets = (const int*)body;
+        const int* lits    = offsets + clauses() + 1;
+        check(offsets, lits);
+        return offsets;
+#else
+        return NULL;
+#endif
+    }
+    const Lit* mappedLits() {
+        assert(encoding() == bcnf_fixed);
+        return (const Lit*)((const int*)body + clauses() + 1); }
+
+    // Decodes the clauses (any encoding) into 'lits' and 'offsets' as for 'Solver::addClauses()'.
+    void decode(vec<Lit>& lits, vec<int>& offsets) {
+        lits.clear(); offsets.clear();
+        lits.capacity((int)literals());
+        offsets.capacity((int)clauses() + 1);
+        offsets.push(0);
+        if (encoding() == bcnf_fixed){
+            const unsigned char* p = body;
+            for (uint64_t i = 0; i <= clauses(); i++, p += 4)
+                if (i > 0) offsets.push((int)get32(p));
+                else if (get32(p) != 0) error("corrupt offsets");
+            for (uint64_t i = 0; i < literals(); i++, p += 4)
+                lits.push(toLit((int)get32(p)));
+        }else{
+            const unsigned char* p   = body;
+            const unsigned char* end = body + body_size;
+            for (uint64_t i = 0; i < clauses(); i++){
+                uint64_t size = getVarint(p, end);
+                if (size > literals() - lits.size()) error("corrupt clause size");
+                for (uint64_t j = 0; j < size; j++){
+                    uint64_t x = getVarint(p, end);
+                    if (x > (uint64_t)INT32_MAX) error("corrupt literal");
+                    lits.push(toLit((int)x)); }
+                offsets.push(lits.size());
+            }
+            if (p != end || (uint64_t)lits.size() != literals()) error("unexpected file size");
+        }
+        check(&offsets[0], lits.size() > 0 ? &lits[0] : NULL);
+    }
+
+private:
+    static uint64_t getVarint(const unsigned char*& p, const unsigned char* end) {
+        uint64_t x = 0;
+        for (int shift = 0; shift < 64; shift += 7){
+            if (p == end) error("unexpected end of file");
+            unsigned char b = *p++;
+            x |= (uint64_t)(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) return x; }
+        error("corrupt varint");
+        return 0; }
+
+    // Offsets must be increasing from 0 to 'literals' and all literals within 'vars':
+    void check(const int* offsets, const void* lits) {
+        if (offsets[0] != 0 || (uint64_t)offsets[clauses()] != literals())
+            error("corrupt offsets");
+        for (uint64_t i = 0; i < clauses(); i++)
+            if (offsets[i+1] < offsets[i]) error("corrupt offsets");
+        const int* ls = (const int*)lits;
+        for (uint64_t i = 0; i < literals(); i++)
+            if (ls[i] < 0 || ls[i] >= 2*vars()) error("literal out of range");
+    }
+};
+
+
+//-------------------------------------------------------------------------------------------------
+// Loading into a solver:
+
+
+// Loads the binary CNF file 'path' through a memory mapping. Returns FALSE without touching the
+// solver if the file can not be mapped or is not in the binary format.
+template<class Solver>
+static bool parse_BinaryCnf(const char* path, Solver& S, int threads = 1) {
+    BinaryCnfReader in;
+    if (!in.open(path))
+        return false;
+
+    while (S.nVars() < in.vars()) S.newVar();
+    const int* offsets = in.mappedOffsets();
+    if (offsets != NULL)
+        S.addClauses(in.mappedLits(), offsets, (int)in.clauses(), threads);
+    else{
+        vec<Lit> lits;
+        vec<int> offs;
+        in.decode(lits, offs);
+        S.addClauses(lits, offs, threads);
+    }
+    return true;
+}
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,85 @@
+#ifndef Minisat_Checkpoint_h
+#define Minisat_Checkpoint_h
+
+#include <stdio.h>
+#include <string.h>
+
+#include "src/mtl/IntTypes.h"
+#include "src/core/BinaryCnf.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Solver checkpoint format:
+//
+// A checkpoint starts with the magic "MSATCKPT" and a 32-bit version, followed by the sections
+// written by 'Solver::writeState()' (and appended to by subclasses, see 'SimpSolver'):
+//
+//   scalars:  clause/variable activity increments, learnt clause limits, random seed, statistics
+//   vars:     number of variables, then for each its activity, saved polarity, user polarity,
+//             user precedence and decision flag
+//   trail:    the top-level assignments
+//   clauses:  the problem clauses, then the learnt clauses (each with its activity)
+//   atmosts:  the at-most constraints (size, bound and literals of each)
+//   xors:     the rows of the XOR matrix (size and literals of each, their XOR being true)
+//
+// Numbers are little-endian as in the binary CNF format ('BinaryCnf.h'); counts, clause sizes and
+// literals ('toInt(Lit)') are LEB128 varints. Every section ends with a 32-bit tag, so a truncated
+// or mismatching file is rejected instead of being loaded partially.
+
+
+static const char ckpt_magic[8] = { 'M', 'S', 'A', 'T', 'C', 'K', 'P', 'T' };
+enum { ckpt_version = 3, ckpt_tag = 0x54504b43 };
+
+
+static inline void ckptPutDouble(FILE* f, double x) {
+    uint64_t bits; memcpy(&bits, &x, sizeof(bits)); bcnfPut64(f, bits); }
+
+static inline void ckptPutFloat(FILE* f, float x) {
+    uint32_t bits; memcpy(&bits, &x, sizeof(bits)); bcnfPut32(f, bits); }
+
+
+// Reading. Errors (premature end of file, a wrong section tag) are sticky: all further reads
+// return 0 and 'ok' stays FALSE.
+class CheckpointReader {
+    FILE* f;
+public:
+    bool  ok;
+
+    explicit CheckpointReader(FILE* _f) : f(_f), ok(true) {}
+
+    uint8_t get8() {
+        int c = ok ? getc(f) : EOF;
+        if (c == EOF){ ok = false; return 0; }
+        return (uint8_t)c; }
+
+    uint32_t get32() {
+        uint32_t x = 0;
+        for (int i = 0; i < 4; i++) x |= (uint32_t)get8() << (8*i);
+        return x; }
+
+    uint64_t get64() {
+        uint64_t lo = get32();
+        return lo | ((uint64_t)get32() << 32); }
+
+    uint32_t getVarint() {
+        uint32_t x = 0;
+        for (int shift = 0; ok && shift < 35; shift += 7){
+            uint8_t b = get8();
+            x |= (uint32_t)(b & 0x7f) << shift;
+            if ((b & 0x80) == 0) return x; }
+        ok = false;
+        return 0; }
+
+    double getDouble() { uint64_t bits = get64(); double x; memcpy(&x, &bits, sizeof(x)); return x; }
+    float  getFloat () { uint32_t bits = get32(); float  x; memcpy(&x, &bits, sizeof(x)); return x; }
+
+    // Check the tag that ends each section:
+    bool   endSection() { if (get32() != (uint32_t)ckpt_tag) ok = false; return ok; }
+};
+
+
+//=================================================================================================
+}
+
+#endif
@@ -22,8 +22,11 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #define Minisat_Dimacs_h
 
 #include <stdio.h>
+#include <thread>
+#include <vector>
 
 #include "src/utils/ParseUtils.h"
+#include "src/utils/MappedFile.h"
 #include "src/core/SolverTypes.h"
 
 namespace Minisat {
@@ -44,6 +47,39 @@ static void readClause(B& in, Solver& S, vec<Lit>& lits) {
     }
 }
 
+// Same as above, but scans the buffered block directly and only falls back to the character-wise
+// 'parseInt()' for a literal that straddles a buffer refill.
+template<class Solver>
+static void readClause(StreamBuffer& in, Solver& S, vec<Lit>& lits) {
+    int     parsed_lit, var;
+    lits.clear();
+    for (;;){
+        int                  avail;
+        const unsigned char* start = in.peek(avail);
+        const unsigned char* end   = start + avail;
+        const unsigned char* p     = start;
+        const unsigned char* next;
+        for (;;){
+            if ((next = scanInt(p, end, parsed_lit)) == NULL) break;
+            p = next;
+            if (parsed_lit == 0) break;
+            var = abs(parsed_lit)-1;
+            while (var >= S.nVars()) S.newVar();
+            lits.push( (parsed_lit > 0) ? mkLit(var) : ~mkLit(var) );
+        }
+        in.skip(p - start);
+        if (next == NULL){
+            parsed_lit = parseInt(in);
+            if (parsed_lit != 0){
+                var = abs(parsed_lit)-1;
+                while (var >= S.nVars()) S.newVar();
+                lits.push( (parsed_lit > 0) ? mkLit(var) : ~mkLit(var) );
+                continue; }
+        }
+        break;
+    }
+}
+
 template<class B, class Solver>
 static void parse_DIMACS_main(B& in, Solver& S, bool strictp = false) {
     vec<Lit> lits;
@@ -57,6 +93,7 @@ static void parse_DIMACS_main(B& in, Solver& S, bool strictp = false) {
             if (eagerMatch(in, "p cnf")){
                 vars    = parseInt(in);
                 clauses = parseInt(in);
+                while (S.nVars() < vars) S.newVar();   // (as in 'parse_DIMACS_mmap()')
                 // SATRACE'06 hack
                 // if (clauses > 4000000)
                 //     S.eliminate(true);
@@ -65,7 +102,13 @@ static void parse_DIMACS_main(B& in, Solver& S, bool strictp = false) {
             }
         } else if (*in == 'c' || *in == 'p')
             skipLine(in);
-        else{
+        else if (*in == 'x'){
+            // XOR constraint (as in CryptoMiniSat): "x1 -2 3 0" means that x1 XOR -x2 XOR x3 is true.
+            ++in;
+            cnt++;
+            readClause(in, S, lits);
+            S.addXor(lits);
+        }else{
             cnt++;
             readClause(in, S, lits);
             S.addClause_(lits); }
@@ -81,6 +124,184 @@ static void parse_DIMACS(gzFile input_stream, Solver& S, bool strictp = false) {
     StreamBuffer in(input_stream);
     parse_DIMACS_main(in, S, strictp); }
 
+template<class Solver>
+static void parse_DIMACS(InputStream& input_stream, Solver& S, bool strictp = false) {
+    StreamBuffer in(input_stream);
+    parse_DIMACS_main(in, S, strictp); }
+
+//=================================================================================================
+// Memory-mapped DIMACS Parser:
+//
+// The file is split into chunks at line boundaries. Each chunk is tokenized independently (and
+// in parallel) into a flat array of integers, where '0' terminates a clause. A clause may span
+// several chunks, so the token arrays are loaded into the solver sequentially and in file order.
+// Comment lines and the header are recognized at the start of a line (after whitespace). The 'x'
+// of an XOR line becomes the token 'dimacs_xor' in front of its literals.
+
+
+struct DimacsChunk {
+    const char* begin;
+    const char* end;
+    vec<int>    tokens;
+    int         vars;      // From the 'p cnf' line, if the chunk contains it (otherwise -1).
+    int         clauses;
+};
+
+
+static const int dimacs_xor = INT32_MIN;
+
+static inline bool isDimacsSpace(char c) { return (c >= 9 && c <= 13) || c == 32; }
+
+static void tokenizeDIMACS(DimacsChunk& chunk)
+{
+    const char* p   = chunk.begin;
+    const char* end = chunk.end;
+    chunk.tokens.clear();
+    chunk.vars = chunk.clauses = -1;
+
+    for (;;){
+        while (p < end && isDimacsSpace(*p)) p++;
+        if (p == end) break;
+
+        if (*p == 'c'){
+            while (p < end && *p != '\n') p++;
+            continue;
+        }else if (*p == 'p'){
+            const char* hdr = "p cnf";
+            for (; *hdr != '\0'; hdr++, p++)
+                if (p == end || *p != *hdr)
+                    fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", p == end ? ' ' : *p), exit(3);
+            int hdr_vals[2];
+            for (int k = 0; k < 2; k++){
+                while (p < end && isDimacsSpace(*p)) p++;
+                int val = 0;
+                if (p == end || *p < '0' || *p > '9')
+                    fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", p == end ? ' ' : *p), exit(3);
+                while (p < end && *p >= '0' && *p <= '9')
+                    val = val*10 + (*p++ - '0');
+                hdr_vals[k] = val;
+            }
+            chunk.vars    = hdr_vals[0];
+            chunk.clauses = hdr_vals[1];
+            continue;
+        }else if (*p == 'x'){
+            chunk.tokens.push(dimacs_xor);
+            p++;
+            continue;
+        }
+
+        bool neg = false;
+        if      (*p == '-') neg = true, p++;
+        else if (*p == '+') p++;
+        if (p == end || *p < '0' || *p > '9')
+            fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", p == end ? ' ' : *p), exit(3);
+        int val = 0;
+        while (p < end && *p >= '0' && *p <= '9')
+            val = val*10 + (*p++ - '0');
+        chunk.tokens.push(neg ? -val : val);
+    }
+}
+
+
+// Parses the (uncompressed) file 'path' via a memory mapping, using up to 'threads' threads for
+// tokenizing. Returns FALSE without touching the solver if the file can not be mapped or looks
+// compressed, in which case the caller should fall back to 'parse_DIMACS()'.
+template<class Solver>
+static bool parse_DIMACS_mmap(const char* path, Solver& S, bool strictp = false, int threads = 1) {
+    MappedFile file;
+    if (!file.open(path))
+        return false;
+
+    const char* data = file.data();
+    uint64_t    size = file.size();
+    if (InputStream::detectFormat((const unsigned char*)data, size) != InputStream::fmt_plain)
+        return false;
+
+    // Chunks are processed in rounds of 'threads' chunks to bound the memory used for tokens:
+    const uint64_t chunk_size = 16*1024*1024;
+    if (threads < 1) threads = 1;
+
+    vec<DimacsChunk> chunks(threads);
+    vec<Lit>         lits;
+    vec<int>         offsets;
+    vec<Lit>         xor_lits;
+    bool             in_xor  = false;
+    int              vars    = 0;
+    int              clauses = 0;
+    int              cnt     = 0;
+    uint64_t         pos     = 0;
+    while (pos < size){
+        // Split the next part of the file at line boundaries:
+        int n = 0;
+        for (; n < threads && pos < size; n++){
+            uint64_t stop = pos + chunk_size < size ? pos + chunk_size : size;
+            while (stop < size && data[stop-1] != '\n') stop++;
+            chunks[n].begin = data + pos;
+            chunks[n].end   = data + stop;
+            pos = stop;
+        }
+
+        std::vector<std::thread> workers;
+        for (int i = 1; i < n; i++)
+            workers.emplace_back(tokenizeDIMACS, std::ref(chunks[i]));
+        tokenizeDIMACS(chunks[0]);
+        for (std::thread& t : workers)
+            t.join();
+
+        // Load in order. Complete clauses are added in bulk, the literals of a clause that
+        // continues in the next round are kept in 'lits':
+        for (int i = 0; i < n; i++){
+            const DimacsChunk& chunk = chunks[i];
+            if (chunk.vars >= 0){
+                vars    = chunk.vars;
+                clauses = chunk.clauses;
+                while (S.nVars() < vars) S.newVar();
+            }
+
+            offsets.clear();
+            offsets.push(0);
+            for (int j = 0; j < chunk.tokens.size(); j++){
+                int parsed_lit = chunk.tokens[j];
+                if (parsed_lit == dimacs_xor){
+                    if (in_xor || lits.size() > offsets.last())
+                        fprintf(stderr, "PARSE ERROR! Unexpected char: x\n"), exit(3);
+                    in_xor = true;
+                }else if (parsed_lit == 0 && in_xor){
+                    // (added right away, before the clauses collected so far)
+                    cnt++;
+                    xor_lits.clear();
+                    for (int k = offsets.last(); k < lits.size(); k++)
+                        xor_lits.push(lits[k]);
+                    lits.shrink(xor_lits.size());
+                    S.addXor(xor_lits);
+                    in_xor = false;
+                }else if (parsed_lit == 0){
+                    cnt++;
+                    offsets.push(lits.size());
+                }else{
+                    int var = abs(parsed_lit)-1;
+                    while (var >= S.nVars()) S.newVar();
+                    lits.push( (parsed_lit > 0) ? mkLit(var) : ~mkLit(var) );
+                }
+            }
+
+            if (offsets.size() > 1){
+                S.addClauses(lits, offsets, threads);
+                int done = offsets.last(), j;
+                for (j = done; j < lits.size(); j++)
+                    lits[j - done] = lits[j];
+                lits.shrink(done);
+            }
+        }
+    }
+
+    if (lits.size() > 0 || in_xor)
+        fprintf(stderr, "PARSE ERROR! Unexpected end of file\n"), exit(3);
+    if (strictp && cnt != clauses)
+        printf("PARSE ERROR! DIMACS header mismatch: wrong number of clauses\n");
+    return true;
+}
+
 //=================================================================================================
 }
 
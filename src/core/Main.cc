@@ -25,6 +25,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "src/utils/System.h"
 #include "src/utils/Options.h"
 #include "src/core/Dimacs.h"
+#include "src/core/BinaryCnf.h"
 #include "src/core/Solver.h"
 #include "src/utils/ExternalWatcher.h" // Include the new header
 
@@ -48,6 +49,19 @@ static void SIGINT_exit(int) {
         printf("\n"); printf("*** INTERRUPTED ***\n"); }
     _exit(1); }
 
+// Checkpoint requests (SIGUSR1 or the checkpoint timer) are served by the solver at its next decision:
+static void SIGUSR1_checkpoint(int) { solver->requestCheckpoint(); }
+
+// Write the statistics to the files given by '-stats-json' and '-stats-csv' (if any):
+static void writeStats(const Solver& S, const char* json, const char* csv) {
+    if (json == NULL && csv == NULL) return;
+    SolverStats stats;
+    S.collectStats(stats);
+    if (json != NULL && !stats.writeJson(json))
+        printf("ERROR! Could not write statistics file: %s\n", json);
+    if (csv != NULL && !stats.writeCsv(csv))
+        printf("ERROR! Could not write statistics file: %s\n", csv); }
+
 
 //=================================================================================================
 // Main:
@@ -56,7 +70,7 @@ static void SIGINT_exit(int) {
 int main(int argc, char** argv)
 {
     try {
-        setUsageHelp("USAGE: %s [options] <input-file> <result-output-file>\n\n  where input may be either in plain or gzipped DIMACS.\n");
+        setUsageHelp("USAGE: %s [options] <input-file> <result-output-file>\n\n  where input may be either in plain or compressed (gzip, bzip2, xz, zstd) DIMACS, or binary CNF.\n");
         setX86FPUPrecision();
 
         // Extra options:
@@ -65,6 +79,19 @@ int main(int argc, char** argv)
         IntOption    cpu_lim("MAIN", "cpu-lim","Limit on CPU time allowed in seconds.\n", 0, IntRange(0, INT32_MAX));
         IntOption    mem_lim("MAIN", "mem-lim","Limit on memory usage in megabytes.\n", 0, IntRange(0, INT32_MAX));
         BoolOption   strictp("MAIN", "strict", "Validate DIMACS header during parsing.", false);
+        BoolOption   use_mmap("MAIN", "mmap",  "Read uncompressed input files through a memory mapping.", true);
+        IntOption    parse_threads("MAIN", "parse-threads", "Number of threads used to parse memory mapped input.", 1, IntRange(1, 256));
+        BoolOption   bg_read  ("MAIN", "bg-read", "Read and decompress input in a background thread.", true);
+        StringOption drat     ("MAIN", "drat",    "If given, write a DRAT proof to this file (not for inputs with XOR constraints).");
+        BoolOption   drat_bin ("MAIN", "drat-binary", "Write the DRAT proof in binary format.", true);
+        StringOption ckpt     ("MAIN", "checkpoint", "If given, save the solver state to this file on SIGUSR1 (and periodically, see below).");
+        IntOption    ckpt_int ("MAIN", "checkpoint-interval", "Seconds between periodic checkpoints (0 = only on SIGUSR1).", 0, IntRange(0, INT32_MAX));
+        StringOption resume   ("MAIN", "resume",  "If given, resume from this checkpoint instead of reading the input file.");
+        StringOption stats_json("MAIN", "stats-json", "If given, write the statistics to this file as JSON (see also '-stats-timers').");
+        StringOption stats_csv ("MAIN", "stats-csv",  "If given, write the statistics to this file as CSV (a header and a line of values).");
+#ifdef MINISAT_TRACE
+        StringOption trace_file("MAIN", "trace",      "If given, record the search events to this file (see 'minisat_trace').");
+#endif
         StringOption watch_socket("MAIN", "watch-socket", "Path to a Unix socket for external watcher.", NULL);
         
         parseOptions(argc, argv, true);
@@ -82,20 +109,40 @@ int main(int argc, char** argv)
         // Try to set resource limits:
         if (cpu_lim != 0) limitTime(cpu_lim);
         if (mem_lim != 0) limitMemory(mem_lim);
+
+        if (drat && resume)
+            printf("ERROR! A proof cannot be written when resuming from a checkpoint.\n"), exit(1);
+        if (drat && !S.proof.open(drat, drat_bin))
+            printf("ERROR! Could not open proof file: %s\n", (const char*)drat), exit(1);
+#ifdef MINISAT_TRACE
+        if (trace_file && !S.trace.open(trace_file))
+            printf("ERROR! Could not open trace file: %s\n", (const char*)trace_file), exit(1);
+#endif
         
-        if (argc == 1)
+        if (argc == 1 && !resume)
             printf("Reading from standard input... Use '--help' for help.\n");
         
-        gzFile in = (argc == 1) ? gzdopen(0, "rb") : gzopen(argv[1], "rb");
-        if (in == NULL)
-            printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
-        
         if (S.verbosity > 0){
             printf("============================[ Problem Statistics ]=============================\n");
             printf("|                                                                             |\n"); }
         
-        parse_DIMACS(in, S, (bool)strictp);
-        gzclose(in);
+        if (resume){
+            if (!S.loadCheckpoint(resume))
+                printf("ERROR! Could not load checkpoint: %s\n", (const char*)resume), exit(1);
+        }else if (argc == 1 || !(parse_BinaryCnf(argv[1], S, parse_threads) ||
+                                 (use_mmap && parse_DIMACS_mmap(argv[1], S, (bool)strictp, parse_threads)))){
+            InputStream in;
+            if (!(argc == 1 ? in.open(dup(0), bg_read) : in.open(argv[1], bg_read)))
+                printf("ERROR! Could not open file: %s\n", argc == 1 ? "<stdin>" : argv[1]), exit(1);
+
+            parse_DIMACS(in, S, (bool)strictp);
+            in.close(); }
+        if (drat && S.hasNative()){
+            // (the steps of XOR reasoning cannot be checked by DRAT; don't leave an invalid proof behind)
+            printf("ERROR! A DRAT proof cannot be written for XOR constraints.\n");
+            S.proof.close();
+            remove(drat);
+            exit(1); }
         FILE* res = (argc >= 3) ? fopen(argv[2], "wb") : NULL;
         
         if (S.verbosity > 0){
@@ -110,6 +157,9 @@ int main(int argc, char** argv)
         // Change to signal-handlers that will only notify the solver and allow it to terminate
         // voluntarily:
         sigTerm(SIGINT_interrupt);
+        if (ckpt){
+            S.checkpoint_file = ckpt;
+            sigCheckpoint(SIGUSR1_checkpoint, ckpt_int); }
        
         if (!S.simplify()){
             if (res != NULL) fprintf(res, "UNSAT\n"), fclose(res);
@@ -119,6 +169,11 @@ int main(int argc, char** argv)
                 S.printStats();
                 printf("\n"); }
             printf("UNSATISFIABLE\n");
+            if (!S.closeProof())
+                printf("ERROR! Could not write proof file: %s\n", (const char*)drat);
+            writeStats(S, stats_json, stats_csv);
+            if (!S.trace.close())
+                printf("ERROR! Could not write trace file\n");
             exit(20);
         }
         
@@ -137,6 +192,11 @@ int main(int argc, char** argv)
             S.printStats();
             printf("\n"); }
         printf(ret == l_True ? "SATISFIABLE\n" : ret == l_False ? "UNSATISFIABLE\n" : "INDETERMINATE\n");
+        if (!S.closeProof())
+            printf("ERROR! Could not write proof file: %s\n", (const char*)drat);
+        writeStats(S, stats_json, stats_csv);
+        if (!S.trace.close())
+            printf("ERROR! Could not write trace file\n");
         if (res != NULL){
             if (ret == l_True){
                 fprintf(res, "SAT\n");
@@ -19,6 +19,12 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 **************************************************************************************************/
 
 #include <math.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 #include "src/core/SolverTypes.h"
 #include "src/mtl/Alg.h"
@@ -26,6 +32,8 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include "src/utils/System.h"
 #include "src/utils/Options.h" // Re-add this include
 #include "src/core/Solver.h"
+#include "src/core/BinaryCnf.h"
+#include "src/core/Checkpoint.h"
 
 using namespace Minisat;
 
@@ -43,6 +51,18 @@ static IntOption     opt_ccmin_mode        (_cat, "ccmin-mode",  "Controls confl
 static IntOption     opt_phase_saving      (_cat, "phase-saving", "Controls the level of phase saving (0=none, 1=limited, 2=full)", 2, IntRange(0, 2));
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
 static IntOption     opt_min_learnts_lim   (_cat, "min-learnts", "Minimum learnt clause limit",  0, IntRange(0, INT32_MAX));
+static BoolOption    opt_inprocess         (_cat, "inprocess",   "Periodically simplify the clause database during search", false);
+static IntOption     opt_inprocess_int     (_cat, "inproc-int",  "Number of conflicts before the first inprocessing round", 10000, IntRange(1, INT32_MAX));
+static DoubleOption  opt_inprocess_inc     (_cat, "inproc-inc",  "Factor by which the inprocessing interval grows", 1.5, DoubleRange(1, true, HUGE_VAL, false));
+static DoubleOption  opt_inprocess_effort  (_cat, "inproc-effort", "Budget of an inprocessing round relative to the propagations since the previous one", 0.1, DoubleRange(0, false, HUGE_VAL, false));
+static BoolOption    opt_vivify            (_cat, "vivify",      "Vivify learnt clauses during inprocessing", true);
+static BoolOption    opt_probe             (_cat, "probe",       "Failed-literal probing and hyper-binary resolution", false);
+static IntOption     opt_probe_props       (_cat, "probe-props", "Propagation budget of probing before the search (in thousands)", 10000, IntRange(0, INT32_MAX));
+static IntOption     opt_probe_hbr         (_cat, "probe-hbr",   "Maximal number of hyper-binary resolvents per probed literal", 16, IntRange(0, INT32_MAX));
+static BoolOption    opt_reuse_trail       (_cat, "reuse-trail", "Keep the levels of a shared assumption prefix between incremental calls", false);
+static BoolOption    opt_assumps_one_level (_cat, "assumps-one-level", "Put all assumptions on a single decision level", false);
+static BoolOption    opt_enum_proj_first   (_cat, "enum-proj-first", "Decide the projected variables first when enumerating models", false);
+static BoolOption    opt_stats_timers      (_cat, "stats-timers", "Measure the time spent in propagation, conflict analysis, reduceDB etc.", false);
 
 
 //=================================================================================================
@@ -74,11 +94,28 @@ Solver::Solver() :
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
 
+  , use_inprocessing   (opt_inprocess)
+  , inprocess_interval (opt_inprocess_int)
+  , inprocess_inc      (opt_inprocess_inc)
+  , inprocess_effort   (opt_inprocess_effort)
+  , use_vivify         (opt_vivify)
+  , use_probing        (opt_probe)
+  , probe_budget       ((int64_t)opt_probe_props * 1000)
+  , probe_max_hbr      (opt_probe_hbr)
+  , checkpoint_file    (NULL)
+  , reuse_trail        (opt_reuse_trail)
+  , assumps_one_level  (opt_assumps_one_level)
+  , enum_proj_first    (opt_enum_proj_first)
+  , stats_timers       (opt_stats_timers)
+
     // Statistics: (formerly in 'SolverStats')
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
   , dec_vars(0), num_clauses(0), num_learnts(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , inprocessings(0), reused_levels(0), core_checks(0)
+  , watcher_visits(0), blocker_hits(0), clause_visits(0)
 
+  , external_watcher   (nullptr)
   , watches            (WatcherDeleted(ca))
   , order_heap         (VarOrderLt(user_prec))
   , ok                 (true)
@@ -87,21 +124,33 @@ Solver::Solver() :
   , qhead              (0)
   , simpDB_assigns     (-1)
   , simpDB_props       (0)
+  , proof_units        (0)
   , progress_estimate  (0)
   , remove_satisfied   (true)
   , next_var           (0)
+  , enumeration        (NULL)
+  , atmost_qhead       (0)
+  , xor_qhead          (0)
+  , native_added       (false)
+  , lazy_confl         (CRef_Undef)
 
     // Resource constraints:
     //
+  , next_inprocess     (0)
+  , inprocess_confl    (0)
+  , inprocess_props    (0)
   , conflict_budget    (-1)
   , propagation_budget (-1)
   , asynch_interrupt   (false)
-  , external_watcher   (nullptr)
+  , checkpoint_requested(false)
+  , checkpoint_pid     (0)
 {}
 
 
 Solver::~Solver()
 {
+    if (checkpoint_pid > 0)
+        waitpid(checkpoint_pid, NULL, 0);
 }
 
 
@@ -125,6 +174,8 @@ Var Solver::newVar(lbool upol, bool dvar)
     watches  .init(mkLit(v, true ));
     assigns  .insert(v, l_Undef);
     vardata  .insert(v, mkVarData(CRef_Undef, 0));
+    atmost_reason.insert(v, -1);
+    xor_reason.insert(v, -1);
     activity .insert(v, 0);
     user_prec.insert(v, v);
     seen     .insert(v, 0);
@@ -141,6 +192,7 @@ Var Solver::newVar(lbool upol, bool dvar)
 // releases of the same variable).
 void Solver::releaseVar(Lit l)
 {
+    cancelKept();
     if (value(l) == l_Undef){
         addClause(l);
         released_vars.push(var(l));
@@ -150,11 +202,13 @@ void Solver::releaseVar(Lit l)
 
 bool Solver::addClause_(vec<Lit>& ps)
 {
+    cancelKept();
     assert(decisionLevel() == 0);
     if (!ok) return false;
 
     // Check if clause is satisfied and remove false/duplicate literals:
     sort(ps);
+    if (proof.active()) ps.copyTo(proof_tmp);
     Lit p; int i, j;
     for (i = j = 0, p = lit_Undef; i < ps.size(); i++)
         if (value(ps[i]) == l_True || ps[i] == ~p)
@@ -163,6 +217,10 @@ bool Solver::addClause_(vec<Lit>& ps)
             ps[j++] = p = ps[i];
     ps.shrink(i - j);
 
+    if (i != j && proof.active()){
+        proof.add(ps);
+        proof.remove(proof_tmp); }
+
     if (ps.size() == 0)
         return ok = false;
     else if (ps.size() == 1){
@@ -178,6 +236,251 @@ bool Solver::addClause_(vec<Lit>& ps)
 }
 
 
+bool Solver::addAtMost(const vec<Lit>& ps, int k)
+{
+    cancelKept();
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+    native_added = true;
+    if (atmosts.size() == 0)
+        atmost_qhead = trail.size();
+    else if (propagate() != CRef_Undef)
+        return ok = false;
+
+    // Remove duplicate and false literals, count (and remove) the true ones. Exactly one literal of
+    // a complementary pair is true:
+    vec<Lit>& lits = lazy_tmp;
+    ps.copyTo(lits);
+    sort(lits);
+    Lit p; int i, j;
+    for (i = j = 0, p = lit_Undef; i < lits.size(); p = lits[i++])
+        if (lits[i] == p || value(lits[i]) == l_False)
+            continue;
+        else if (value(lits[i]) == l_True)
+            k--;
+        else if (lits[i] == ~p && j > 0 && lits[j-1] == p)
+            j--, k--;
+        else
+            lits[j++] = lits[i];
+    lits.shrink(i - j);
+
+    if (k < 0)
+        return ok = false;
+    else if (k >= lits.size())
+        return true;
+    else if (k == 0){
+        for (int i = 0; i < lits.size(); i++)
+            uncheckedEnqueue(~lits[i]);
+        return ok = (propagate() == CRef_Undef);
+    }
+
+    attachAtMost(lits, k);
+    return true;
+}
+
+
+void Solver::attachAtMost(const vec<Lit>& ps, int k)
+{
+    AtMost a;
+    a.lits  = atmost_lits.size();
+    a.size  = ps.size();
+    a.k     = k;
+    a.count = 0;
+    atmost_occs.growTo(2*nVars());
+    for (int i = 0; i < ps.size(); i++){
+        atmost_lits.push(ps[i]);
+        atmost_occs[toInt(ps[i])].push(atmosts.size()); }
+    for (int i = 0; i <= k; i++)
+        atmost_lits.push(lit_Undef);
+    atmosts.push(a);
+}
+
+
+bool Solver::addXor(const vec<Lit>& ps)
+{
+    cancelKept();
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+    native_added = true;
+    if (xor_var.size() == 0)
+        xor_qhead = trail.size();
+    else if (propagateXor() != CRef_Undef || propagate() != CRef_Undef)
+        return ok = false;
+
+    // Turn the literals into a sum of unassigned variables equal to 'rhs'; a variable that occurs
+    // twice cancels out:
+    vec<Lit>& lits = lazy_tmp;
+    bool      rhs  = true;
+    ps.copyTo(lits);
+    for (int i = 0; i < lits.size(); i++){
+        rhs    ^= sign(lits[i]);
+        lits[i] = mkLit(var(lits[i])); }
+    sort(lits);
+    int i, j;
+    for (i = j = 0; i < lits.size(); i++)
+        if (i + 1 < lits.size() && lits[i] == lits[i+1])
+            i++;
+        else if (value(lits[i]) != l_Undef)
+            rhs ^= value(lits[i]) == l_True;
+        else
+            lits[j++] = lits[i];
+    lits.shrink(i - j);
+
+    if (lits.size() == 0){
+        if (rhs) return ok = false;
+        return true; }
+
+    // Add the row, with columns for new variables:
+    for (int i = 0; i < lits.size(); i++){
+        Var v = var(lits[i]);
+        xor_col.growTo(v + 1, -1);
+        if (xor_col[v] < 0){
+            xor_col[v] = xor_var.size();
+            xor_var.push(v);
+            xor_basic_row.push(-1);
+            xor_watches.push(); }
+    }
+    assert(xor_expl.size() == 0);
+    xor_rows.growCols(xor_var.size());
+    xor_assigned.growTo(xor_rows.stride(), 0);
+    xor_values  .growTo(xor_rows.stride(), 0);
+
+    int r = xor_rows.addRow();
+    for (int i = 0; i < lits.size(); i++)
+        bitFlip(xor_rows[r], xor_col[var(lits[i])]);
+    xor_rhs.push(rhs);
+
+    // Eliminate the basic columns of the other rows, then pick a basic column for the new one:
+    for (int c = 0; c < xor_var.size(); c++)
+        if (xor_basic_row[c] >= 0 && bitGet(xor_rows[r], c)){
+            xor_rows.xorRow(r, xor_basic_row[c]);
+            xor_rhs[r] ^= xor_rhs[xor_basic_row[c]]; }
+    if (xor_rows.isZero(r)){
+        rhs = xor_rhs[r];
+        xor_rows.removeRow();
+        xor_rhs.pop();
+        if (rhs) return ok = false;
+        return true; }
+
+    int c = xorUnassigned(xor_rows[r], -1);
+    if (c < 0) c = xor_rows.firstCol(r);
+    assert(c >= 0);
+    xor_basic.push(-1);
+    xor_watch.push(-1);
+    xor_in_dirty.push(1);
+    xor_dirty.push(r);
+    pivotXor(r, c);
+
+    if (propagateXor() != CRef_Undef)
+        return ok = false;
+    return ok = (propagate() == CRef_Undef);
+}
+
+
+// Sort the literals of clause 'ps' (of 'size' literals), remove duplicates and false literals.
+// Returns the new size, or -1 if the clause is satisfied or a tautology. The assignment is only
+// read, so this can run concurrently for different clauses.
+static int normalizeClause(Lit* ps, int size, const VMap<lbool>& assigns)
+{
+    // Insertion sort (clauses are usually short):
+    for (int i = 1; i < size; i++){
+        Lit p = ps[i];
+        int j;
+        for (j = i; j > 0 && p < ps[j-1]; j--)
+            ps[j] = ps[j-1];
+        ps[j] = p;
+    }
+
+    Lit p; int i, j;
+    for (i = j = 0, p = lit_Undef; i < size; i++){
+        lbool val = assigns[var(ps[i])] ^ sign(ps[i]);
+        if (val == l_True || ps[i] == ~p)
+            return -1;
+        else if (val != l_False && ps[i] != p)
+            ps[j++] = p = ps[i];
+    }
+    return j;
+}
+
+
+bool Solver::addClauses(const Lit* lits, const int* offsets, int n_clauses, int threads)
+{
+    cancelKept();
+    assert(decisionLevel() == 0);
+    if (!ok) return false;
+    if (n_clauses == 0) return true;
+
+    // Normalize all clauses into a private copy of the literals, in parallel if requested:
+    vec<Lit>  ps(offsets[n_clauses]);
+    vec<int>  sizes(n_clauses);
+    for (int i = offsets[0]; i < offsets[n_clauses]; i++) ps[i] = lits[i];
+
+    auto normalize = [&](int from, int to){
+        for (int i = from; i < to; i++)
+            sizes[i] = normalizeClause(&ps[offsets[i]], offsets[i+1] - offsets[i], assigns); };
+    if (threads > 1 && n_clauses >= 4096){
+        std::vector<std::thread> workers;
+        int step = (n_clauses + threads - 1) / threads;
+        for (int t = 1; t < threads; t++)
+            workers.emplace_back(normalize, std::min(t*step, n_clauses), std::min((t+1)*step, n_clauses));
+        normalize(0, std::min(step, n_clauses));
+        for (std::thread& w : workers)
+            w.join();
+    }else
+        normalize(0, n_clauses);
+
+    // Reserve memory for clauses and watches up front:
+    vec<int> n_watches(2*nVars(), 0);
+    uint64_t n_long = 0, n_lits = 0;
+    for (int i = 0; i < n_clauses; i++)
+        if (sizes[i] >= 2){
+            const Lit* c = &ps[offsets[i]];
+            n_watches[toInt(~c[0])]++;
+            n_watches[toInt(~c[1])]++;
+            n_long++;
+            n_lits += sizes[i]; }
+    ca.reserve(n_long, n_lits);
+    clauses.capacity(clauses.size() + (int)n_long);
+    for (int i = 0; i < n_watches.size(); i++)
+        if (n_watches[i] > 0){
+            vec<Watcher>& ws = watches[toLit(i)];
+            ws.capacity(ws.size() + n_watches[i]); }
+
+    // Allocate and attach. Units are propagated right away; after that, clauses must be checked
+    // again against the new assignment (like 'addClause_()' would do):
+    int assigns_before = trail.size();
+    for (int i = 0; i < n_clauses; i++){
+        int size = sizes[i];
+        Lit* c   = &ps[offsets[i]];
+        if (size > 0 && trail.size() > assigns_before){
+            int j, k;
+            for (j = k = 0; j < size; j++)
+                if (value(c[j]) == l_True) break;
+                else if (value(c[j]) != l_False) c[k++] = c[j];
+            size = j < size ? -1 : k;
+        }
+
+        if (size >= 0 && size != offsets[i+1] - offsets[i] && proof.active()){
+            proof.add(c, size);
+            proof.remove(&lits[offsets[i]], offsets[i+1] - offsets[i]); }
+
+        if (size == 0)
+            return ok = false;
+        else if (size == 1){
+            uncheckedEnqueue(c[0]);
+            if (propagate() != CRef_Undef)
+                return ok = false;
+        }else if (size > 1){
+            CRef cr = ca.alloc(c, size, false);
+            clauses.push(cr);
+            attachClause(cr);
+        }
+    }
+
+    return true;
+}
+
+
 void Solver::attachClause(CRef cr){
     const Clause& c = ca[cr];
     assert(c.size() > 1);
@@ -208,6 +511,9 @@ void Solver::detachClause(CRef cr, bool strict){
 
 void Solver::removeClause(CRef cr) {
     Clause& c = ca[cr];
+    if (proof.active()){
+        logUnits();
+        proof.remove(c); }
     detachClause(cr);
     // Don't leave pointers to free'd memory!
     if (locked(c)) vardata[var(c[0])].reason = CRef_Undef;
@@ -227,6 +533,9 @@ bool Solver::satisfied(const Clause& c) const {
 //
 void Solver::cancelUntil(int level) {
     if (decisionLevel() > level){
+        if (atmosts.size() > 0) cancelAtMost(level);
+        if (xor_var.size() > 0) cancelXor(level);
+        if (atmosts.size() > 0 || xor_var.size() > 0) cancelLazy(level);
         for (int c = trail.size()-1; c >= trail_lim[level]; c--){
             Var      x  = var(trail[c]);
             assigns [x] = l_Undef;
@@ -239,6 +548,48 @@ void Solver::cancelUntil(int level) {
     } }
 
 
+// Uncount the literals above 'level' and free the reason clauses built for them:
+void Solver::cancelAtMost(int level) {
+    for (int c = atmost_qhead-1; c >= trail_lim[level]; c--){
+        Lit p = trail[c];
+        if (toInt(p) >= atmost_occs.size()) continue;
+        const vec<int>& occs = atmost_occs[toInt(p)];
+        for (int i = 0; i < occs.size(); i++){
+            AtMost& a = atmosts[occs[i]];
+            a.count--;
+            assert(atmost_lits[a.lits + a.size + a.count] == p); }
+    }
+    atmost_qhead = std::min(atmost_qhead, trail_lim[level]);
+}
+
+
+// Unassign the columns above 'level' in the XOR matrix:
+void Solver::cancelXor(int level) {
+    for (int c = xor_qhead-1; c >= trail_lim[level]; c--){
+        Var x = var(trail[c]);
+        if (x < xor_col.size() && xor_col[x] >= 0)
+            xor_assigned[bitWord(xor_col[x])] &= ~bitMask(xor_col[x]);
+    }
+    xor_qhead = std::min(xor_qhead, trail_lim[level]);
+}
+
+
+// Free the reason clauses built for the implications above 'level' and the copied XOR rows:
+void Solver::cancelLazy(int level) {
+    int expl = xor_expl.size();
+    for (int c = trail.size()-1; c >= trail_lim[level]; c--){
+        Var x = var(trail[c]);
+        if (atmost_reason[x] >= 0 || xor_reason[x] >= 0){
+            if (reason(x) != CRef_Lazy)
+                ca.free(reason(x));
+            if (xor_reason[x] >= 0)
+                expl = xor_reason[x];
+            atmost_reason[x] = xor_reason[x] = -1; }
+    }
+    xor_expl.shrink(xor_expl.size() - expl);
+}
+
+
 //=================================================================================================
 // Major methods:
 
@@ -292,6 +643,7 @@ Lit Solver::pickBranchLit()
 |________________________________________________________________________________________________@*/
 void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 {
+    PhaseTimer timer(time_analyze, stats_timers);
     int pathC = 0;
     Lit p     = lit_Undef;
 
@@ -323,7 +675,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
         // Select next clause to look at:
         while (!seen[var(trail[index--])]);
         p     = trail[index+1];
-        confl = reason(var(p));
+        confl = reasonClause(var(p));
         seen[var(p)] = 0;
         pathC--;
 
@@ -346,7 +698,7 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
             if (reason(x) == CRef_Undef)
                 out_learnt[j++] = out_learnt[i];
             else{
-                Clause& c = ca[reason(var(out_learnt[i]))];
+                Clause& c = ca[reasonClause(x)];
                 for (int k = 1; k < c.size(); k++)
                     if (!seen[var(c[k])] && level(var(c[k])) > 0){
                         out_learnt[j++] = out_learnt[i];
@@ -382,13 +734,27 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel)
 
 
 // Check if 'p' can be removed from a conflict clause.
+// The number of distinct decision levels in 'c' (its "literal block distance"):
+int Solver::computeLBD(const vec<Lit>& c)
+{
+    lbd_seen.growTo(decisionLevel() + 1, 0);
+    int n = 0;
+    for (int i = 0; i < c.size(); i++){
+        int l = level(var(c[i]));
+        if (!lbd_seen[l]){ lbd_seen[l] = 1; n++; } }
+    for (int i = 0; i < c.size(); i++)
+        lbd_seen[level(var(c[i]))] = 0;
+    return n;
+}
+
+
 bool Solver::litRedundant(Lit p)
 {
     enum { seen_undef = 0, seen_source = 1, seen_removable = 2, seen_failed = 3 };
     assert(seen[var(p)] == seen_undef || seen[var(p)] == seen_source);
     assert(reason(var(p)) != CRef_Undef);
 
-    Clause*               c     = &ca[reason(var(p))];
+    Clause*               c     = &ca[reasonClause(var(p))];
     vec<ShrinkStackElem>& stack = analyze_stack;
     stack.clear();
 
@@ -417,7 +783,7 @@ bool Solver::litRedundant(Lit p)
             stack.push(ShrinkStackElem(i, p));
             i  = 0;
             p  = l;
-            c  = &ca[reason(var(p))];
+            c  = &ca[reasonClause(var(p))];
         }else{
             // Finished with current element 'p' and reason 'c':
             if (seen[var(p)] == seen_undef){
@@ -431,7 +797,7 @@ bool Solver::litRedundant(Lit p)
             // Continue with top element on stack:
             i  = stack.last().i;
             p  = stack.last().l;
-            c  = &ca[reason(var(p))];
+            c  = &ca[reasonClause(var(p))];
 
             stack.pop();
         }
@@ -459,7 +825,31 @@ void Solver::analyzeFinal(Lit p, LSet& out_conflict)
         return;
 
     seen[var(p)] = 1;
+    analyzeFinalMarked(out_conflict);
+    seen[var(p)] = 0;
+}
+
+
+// Same as above for a conflicting clause 'confl' (all its literals are false):
+void Solver::analyzeFinal(CRef confl, LSet& out_conflict)
+{
+    out_conflict.clear();
+
+    if (decisionLevel() == 0)
+        return;
 
+    const Clause& c = ca[confl];
+    for (int j = 0; j < c.size(); j++)
+        if (level(var(c[j])) > 0)
+            seen[var(c[j])] = 1;
+    analyzeFinalMarked(out_conflict);
+}
+
+
+// Adds the negations of the decisions that the marked ('seen') variables depend on to
+// 'out_conflict', and clears the marks:
+void Solver::analyzeFinalMarked(LSet& out_conflict)
+{
     for (int i = trail.size()-1; i >= trail_lim[0]; i--){
         Var x = var(trail[i]);
         if (seen[x]){
@@ -467,7 +857,7 @@ void Solver::analyzeFinal(Lit p, LSet& out_conflict)
                 assert(level(x) > 0);
                 out_conflict.insert(~trail[i]);
             }else{
-                Clause& c = ca[reason(x)];
+                Clause& c = ca[reasonClause(x)];
                 for (int j = 1; j < c.size(); j++)
                     if (level(var(c[j])) > 0)
                         seen[var(c[j])] = 1;
@@ -475,8 +865,6 @@ void Solver::analyzeFinal(Lit p, LSet& out_conflict)
             seen[x] = 0;
         }
     }
-
-    seen[var(p)] = 0;
 }
 
 
@@ -502,19 +890,35 @@ void Solver::uncheckedEnqueue(Lit p, CRef from)
 |________________________________________________________________________________________________@*/
 CRef Solver::propagate()
 {
+    PhaseTimer timer(time_propagate, stats_timers);
     CRef    confl     = CRef_Undef;
     int     num_props = 0;
+    int     num_visits = 0, num_blocked = 0;
+
+    if (lazy_confl != CRef_Undef){
+        ca.free(lazy_confl);
+        lazy_confl = CRef_Undef; }
 
     while (qhead < trail.size()){
+        // Count the new assignments in the at-most constraints and the XOR matrix first:
+        if (atmosts.size() > 0 && atmost_qhead < trail.size() && (confl = propagateAtMost()) != CRef_Undef){
+            qhead = trail.size();
+            break; }
+        if (xor_var.size() > 0 && xor_qhead < trail.size() && (confl = propagateXor()) != CRef_Undef){
+            qhead = trail.size();
+            break; }
+
         Lit            p   = trail[qhead++];     // 'p' is enqueued fact to propagate.
         vec<Watcher>&  ws  = watches.lookup(p);
         Watcher        *i, *j, *end;
         num_props++;
+        num_visits += ws.size();
 
         for (i = j = (Watcher*)ws, end = i + ws.size();  i != end;){
             // Try to avoid inspecting the clause:
             Lit blocker = i->blocker;
             if (value(blocker) == l_True){
+                num_blocked++;
                 *j++ = *i++; continue; }
 
             // Make sure the false literal is data[1]:
@@ -545,6 +949,7 @@ CRef Solver::propagate()
                 confl = cr;
                 qhead = trail.size();
                 // Copy the remaining watches:
+                num_visits -= end - i;
                 while (i < end)
                     *j++ = *i++;
             }else
@@ -554,13 +959,220 @@ CRef Solver::propagate()
         }
         ws.shrink(i - j);
     }
-    propagations += num_props;
-    simpDB_props -= num_props;
+    propagations   += num_props;
+    simpDB_props   -= num_props;
+    watcher_visits += num_visits;
+    blocker_hits   += num_blocked;
+    clause_visits  += num_visits - num_blocked;
+
+    return confl;
+}
 
+
+// Counts 'trail[atmost_qhead..]' in the at-most constraints. A constraint that reaches its bound
+// makes its other literals false; one that exceeds it is returned as a conflict clause.
+CRef Solver::propagateAtMost()
+{
+    CRef confl = CRef_Undef;
+
+    while (confl == CRef_Undef && atmost_qhead < trail.size()){
+        Lit p = trail[atmost_qhead++];
+        if (toInt(p) >= atmost_occs.size()) continue;
+
+        // (all constraints of 'p' are counted even after a conflict, see 'cancelAtMost()')
+        const vec<int>& occs = atmost_occs[toInt(p)];
+        for (int i = 0; i < occs.size(); i++){
+            AtMost& a       = atmosts[occs[i]];
+            Lit*    counted = &atmost_lits[a.lits + a.size];
+            assert(a.count <= a.k);
+            counted[a.count++] = p;
+
+            if (a.count == a.k){
+                const Lit* lits = &atmost_lits[a.lits];
+                for (int j = 0; j < a.size; j++)
+                    if (value(lits[j]) == l_Undef){
+                        atmost_reason[var(lits[j])] = occs[i];
+                        uncheckedEnqueue(~lits[j], CRef_Lazy); }
+            }else if (a.count > a.k && confl == CRef_Undef){
+                lazy_tmp.clear();
+                for (int j = 0; j < a.count; j++)
+                    lazy_tmp.push(~counted[j]);
+                confl = lazy_confl = ca.alloc(lazy_tmp, false);
+            }
+        }
+    }
     return confl;
 }
 
 
+// Brings the XOR matrix up to date with 'trail[xor_qhead..]'. Rows watching a newly assigned column
+// (as basic or watched column) are updated; a row whose basic column is assigned gets a new one if
+// possible, which changes the rows containing that column as well.
+CRef Solver::propagateXor()
+{
+    CRef confl = CRef_Undef;
+
+    for (;;){
+        // (changed rows are updated even after a conflict, so that their watches stay valid)
+        while (xor_dirty.size() > 0){
+            int r = xor_dirty.last();
+            xor_dirty.pop();
+            xor_in_dirty[r] = 0;
+            if (updateXor(r) && confl == CRef_Undef)
+                confl = lazy_confl = xorClause(xor_rows[r], lit_Undef);
+        }
+        if (confl != CRef_Undef || xor_qhead == trail.size()) break;
+
+        Lit p = trail[xor_qhead++];
+        int c = var(p) < xor_col.size() ? xor_col[var(p)] : -1;
+        if (c < 0) continue;
+        xor_assigned[bitWord(c)] |= bitMask(c);
+        if (sign(p)) xor_values[bitWord(c)] &= ~bitMask(c);
+        else         xor_values[bitWord(c)] |=  bitMask(c);
+
+        int r = xor_basic_row[c];
+        if (r >= 0 && updateXor(r))
+            confl = lazy_confl = xorClause(xor_rows[r], lit_Undef);
+
+        // Rows that stop watching 'c' are dropped from its list:
+        xor_watches[c].moveTo(xor_ws);
+        int i, j;
+        for (i = j = 0; i < xor_ws.size(); i++){
+            int r = xor_ws[i];
+            if (xor_watch[r] != c) continue;
+            if (confl == CRef_Undef && updateXor(r))
+                confl = lazy_confl = xorClause(xor_rows[r], lit_Undef);
+            if (xor_watch[r] == c)
+                xor_ws[j++] = r;
+        }
+        xor_ws.shrink(i - j);
+        for (i = 0; i < xor_ws.size(); i++)
+            xor_watches[c].push(xor_ws[i]);
+    }
+    return confl;
+}
+
+
+int Solver::xorUnassigned(const uint64_t* row, int skip) const
+{
+    for (int i = 0; i < xor_rows.stride(); i++){
+        uint64_t m = row[i] & ~xor_assigned[i];
+        if (skip >= 0 && i == bitWord(skip)) m &= ~bitMask(skip);
+        if (m != 0) return i*64 + bitFirst(m);
+    }
+    return -1;
+}
+
+
+bool Solver::updateXor(int r)
+{
+    const uint64_t* row = xor_rows[r];
+    int             b   = xor_basic[r];
+    int             w;
+
+    if ((xor_assigned[bitWord(b)] & bitMask(b)) != 0){
+        // The basic column is assigned, make another one basic:
+        if ((w = xorUnassigned(row, -1)) >= 0){
+            pivotXor(r, w);
+            b = w;
+        }else{
+            int parity = xor_rhs[r];
+            for (int i = 0; i < xor_rows.stride(); i++)
+                parity ^= bitParity(row[i] & xor_values[i]);
+            if (parity != 0) return true;
+            b = -1; }
+    }
+
+    if (b >= 0 && (w = xorUnassigned(row, b)) >= 0){
+        if (w != xor_watch[r]){
+            xor_watch[r] = w;
+            xor_watches[w].push(r); }
+        return false; }
+
+    // All columns but (possibly) the basic one are assigned. Watch the one assigned last, so the row
+    // is looked at again when backtracking leaves it with two unassigned columns:
+    w = -1;
+    for (int i = 0; i < xor_rows.stride(); i++)
+        for (uint64_t m = row[i]; m != 0; m &= m - 1){
+            int c = i*64 + bitFirst(m);
+            if (c != xor_basic[r] && (w < 0 || level(xor_var[c]) > level(xor_var[w])))
+                w = c; }
+    if (w >= 0 && w != xor_watch[r]){
+        xor_watch[r] = w;
+        xor_watches[w].push(r); }
+    if (b < 0) return false;
+
+    // Imply the basic variable:
+    int parity = xor_rhs[r];
+    for (int i = 0; i < xor_rows.stride(); i++)
+        parity ^= bitParity(row[i] & xor_assigned[i] & xor_values[i]);
+    Lit p = mkLit(xor_var[b], parity == 0);
+    if (value(p) == l_False)
+        return true;
+    else if (value(p) == l_Undef){
+        if (decisionLevel() == 0)
+            uncheckedEnqueue(p);
+        else{
+            xor_reason[var(p)] = xor_expl.size();
+            for (int i = 0; i < xor_rows.stride(); i++)
+                xor_expl.push(row[i]);
+            uncheckedEnqueue(p, CRef_Lazy); }
+    }
+    return false;
+}
+
+
+// Eliminate column 'c' from the other rows:
+void Solver::pivotXor(int r, int c)
+{
+    for (int i = 0; i < xor_basic.size(); i++)
+        if (i != r && bitGet(xor_rows[i], c)){
+            xor_rows.xorRow(i, r);
+            xor_rhs[i] ^= xor_rhs[r];
+            if (!xor_in_dirty[i]){
+                xor_in_dirty[i] = 1;
+                xor_dirty.push(i); }
+        }
+    if (xor_basic[r] >= 0)
+        xor_basic_row[xor_basic[r]] = -1;
+    xor_basic_row[c] = r;
+    xor_basic[r]     = c;
+}
+
+
+// The clause of the (fully assigned) variables of 'row': every literal is false, except 'implied'.
+CRef Solver::xorClause(const uint64_t* row, Lit implied)
+{
+    lazy_tmp.clear();
+    if (implied != lit_Undef)
+        lazy_tmp.push(implied);
+    for (int i = 0; i < xor_rows.stride(); i++)
+        for (uint64_t m = row[i]; m != 0; m &= m - 1){
+            Var v = xor_var[i*64 + bitFirst(m)];
+            if (implied == lit_Undef || v != var(implied))
+                lazy_tmp.push(mkLit(v, value(v) == l_True));
+        }
+    return ca.alloc(lazy_tmp, false);
+}
+
+
+CRef Solver::lazyReason(Var x)
+{
+    Lit p = mkLit(x, value(x) == l_False);
+    if (atmost_reason[x] < 0)
+        return vardata[x].reason = xorClause(&xor_expl[xor_reason[x]], p);
+
+    // Implied by an at-most constraint: the first 'k' counted literals were true before 'x' was assigned.
+    const AtMost& a       = atmosts[atmost_reason[x]];
+    const Lit*    counted = &atmost_lits[a.lits + a.size];
+    lazy_tmp.clear();
+    lazy_tmp.push(p);
+    for (int i = 0; i < a.k; i++)
+        lazy_tmp.push(~counted[i]);
+    return vardata[x].reason = ca.alloc(lazy_tmp, false);
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  reduceDB : ()  ->  [void]
@@ -577,6 +1189,7 @@ struct reduceDB_lt {
 };
 void Solver::reduceDB()
 {
+    PhaseTimer timer(time_reduce, stats_timers, true);
     int     i, j;
     double  extra_lim = cla_inc / learnts.size();    // Remove any clause below this activity
 
@@ -593,6 +1206,7 @@ void Solver::reduceDB()
             learnts[j++] = learnts[i];
     }
     learnts.shrink(i - j);
+    TRACE_EVENT(trace, trace_reduce, decisionLevel(), conflicts, i - j, j);
     checkGarbage();
 }
 
@@ -607,11 +1221,18 @@ void Solver::removeSatisfied(vec<CRef>& cs)
         else{
             // Trim clause:
             assert(value(c[0]) == l_Undef && value(c[1]) == l_Undef);
+            int size_before = c.size();
+            if (proof.active()){
+                proof_tmp.clear();
+                for (int k = 0; k < c.size(); k++) proof_tmp.push(c[k]); }
             for (int k = 2; k < c.size(); k++)
                 if (value(c[k]) == l_False){
                     c[k--] = c[c.size()-1];
                     c.pop();
                 }
+            if (c.size() != size_before && proof.active()){
+                proof.add(c);
+                proof.remove(proof_tmp); }
             cs[j++] = cs[i];
         }
     }
@@ -639,6 +1260,8 @@ void Solver::rebuildOrderHeap()
 |________________________________________________________________________________________________@*/
 bool Solver::simplify()
 {
+    PhaseTimer timer(time_simplify, stats_timers, true);
+    cancelKept();
     assert(decisionLevel() == 0);
 
     if (!ok || propagate() != CRef_Undef)
@@ -648,6 +1271,7 @@ bool Solver::simplify()
         return true;
 
     // Remove satisfied clauses:
+    logUnits();
     removeSatisfied(learnts);
     if (remove_satisfied){       // Can be turned off.
         removeSatisfied(clauses);
@@ -667,6 +1291,9 @@ bool Solver::simplify()
         trail.shrink(i - j);
         //printf("trail.size()= %d, qhead = %d\n", trail.size(), qhead);
         qhead = trail.size();
+        atmost_qhead = trail.size();
+        xor_qhead = trail.size();
+        proof_units = trail.size();
 
         for (int i = 0; i < released_vars.size(); i++)
             seen[released_vars[i]] = 0;
@@ -685,6 +1312,372 @@ bool Solver::simplify()
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  inprocess : [void]  ->  [bool]
+|  
+|  Description:
+|    Simplify the clause database at level 0 in the middle of the search. Called by 'search()'
+|    whenever 'next_inprocess' conflicts are reached. The effort is measured in ticks (propagations
+|    or visited literals) and is limited to a fraction of the propagations done by the search since
+|    the previous round, so that it scales with search progress. Returns FALSE if the problem was
+|    found to be unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::inprocess()
+{
+    assert(decisionLevel() == 0);
+    inprocessings++;
+
+    int64_t ticks = (int64_t)((propagations - inprocess_props) * inprocess_effort);
+
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    if (!subsumeLearnts(ticks))
+        return false;
+
+    if (use_vivify && !vivifyLearnts(ticks))
+        return false;
+
+    if (use_probing && !probe(ticks))
+        return false;
+
+    inprocess_confl *= inprocess_inc;
+    next_inprocess   = conflicts + (uint64_t)inprocess_confl;
+    inprocess_props  = propagations;
+
+    if (verbosity >= 2)
+        printf("|  Inprocessing round %-6" PRIu64 "  subsumed: %-10" PRIu64 " vivified: %-10" PRIu64 "  |\n",
+               inprocessings, stats_subsume.clauses, stats_vivify.clauses);
+
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  subsumeLearnts : (ticks : int64_t)  ->  [bool]
+|  
+|  Description:
+|    Remove learnt clauses subsumed by a problem clause or by a smaller learnt clause. Clauses are
+|    visited by increasing size and each kept clause is indexed under one of its literals
+|    (one-watched occurrence lists). A candidate is checked against the clauses indexed under
+|    each of its literals, with its own literals marked in 'seen'. Stops early when 'ticks'
+|    literal visits are used up.
+|________________________________________________________________________________________________@*/
+struct subsume_lt {
+    ClauseAllocator& ca;
+    subsume_lt(ClauseAllocator& ca_) : ca(ca_) {}
+    bool operator () (CRef x, CRef y) { 
+        return ca[x].size() < ca[y].size() || (ca[x].size() == ca[y].size() && !ca[x].learnt() && ca[y].learnt()); }
+};
+bool Solver::subsumeLearnts(int64_t ticks)
+{
+    assert(decisionLevel() == 0);
+    double start_time = cpuTime();
+    stats_subsume.runs++;
+
+    vec<CRef> cs;
+    for (int i = 0; i < clauses.size(); i++) cs.push(clauses[i]);
+    for (int i = 0; i < learnts.size(); i++) cs.push(learnts[i]);
+    sort(cs, subsume_lt(ca));
+
+    vec<vec<CRef> > occ(2*nVars());
+    for (int i = 0; i < cs.size() && ticks > 0; i++){
+        CRef    cr = cs[i];
+        Clause& c  = ca[cr];
+        if (c.mark() != 0) continue;
+
+        if (c.learnt()){
+            for (int k = 0; k < c.size(); k++)
+                seen[var(c[k])] = 1 + sign(c[k]);
+
+            bool subsumed = false;
+            for (int k = 0; k < c.size() && !subsumed; k++){
+                const vec<CRef>& ds = occ[toInt(c[k])];
+                for (int j = 0; j < ds.size() && !subsumed; j++){
+                    const Clause& d = ca[ds[j]];
+                    int l;
+                    for (l = 0; l < d.size() && seen[var(d[l])] == 1 + sign(d[l]); l++);
+                    ticks -= l + 1;
+                    subsumed = l == d.size();
+                }
+            }
+
+            for (int k = 0; k < c.size(); k++)
+                seen[var(c[k])] = 0;
+
+            if (subsumed && !c.persistent()){
+                stats_subsume.clauses++;
+                stats_subsume.literals += c.size();
+                removeClause(cr);
+                continue;
+            }
+        }
+
+        // Index the clause under its literal with the shortest occurrence list:
+        Lit best = c[0];
+        for (int k = 1; k < c.size(); k++)
+            if (occ[toInt(c[k])].size() < occ[toInt(best)].size())
+                best = c[k];
+        occ[toInt(best)].push(cr);
+        ticks -= c.size();
+    }
+
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++)
+        if (!isRemoved(learnts[i]))
+            learnts[j++] = learnts[i];
+    learnts.shrink(i - j);
+    checkGarbage();
+
+    stats_subsume.time += cpuTime() - start_time;
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  vivifyLearnts : (ticks : int64_t)  ->  [bool]
+|  
+|  Description:
+|    Vivify the more active half of the learnt clauses, i.e. the ones that the next call to
+|    'reduceDB()' would keep. Clauses are visited by decreasing activity until 'ticks'
+|    propagations are used up. Returns FALSE if the problem was found to be unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::vivifyLearnts(int64_t ticks)
+{
+    assert(decisionLevel() == 0);
+    double start_time = cpuTime();
+    stats_vivify.runs++;
+
+    vec<CRef> cs;
+    for (int i = 0; i < learnts.size(); i++) cs.push(learnts[i]);
+    sort(cs, reduceDB_lt(ca));
+
+    uint64_t props_before = propagations;
+    for (int i = cs.size() - 1; i >= cs.size() / 2 && ok; i--){
+        if ((int64_t)(propagations - props_before) > ticks)
+            break;
+
+        Clause& c = ca[cs[i]];
+        if (c.mark() != 0 || c.size() <= 2 || c.persistent() || locked(c) || satisfied(c))
+            continue;
+
+        if (!vivifyClause(cs[i]))
+            ok = false;
+    }
+
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++)
+        if (!isRemoved(learnts[i]))
+            learnts[j++] = learnts[i];
+    learnts.shrink(i - j);
+    checkGarbage();
+
+    stats_vivify.time += cpuTime() - start_time;
+    return ok;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  vivifyClause : (cr : CRef)  ->  [bool]
+|  
+|  Description:
+|    Assign the negations of the literals of a learnt clause one by one on a fresh decision level,
+|    in the same way as 'implies()', with the clause itself detached. A literal that is already
+|    false is redundant and is dropped. If a literal is already true, or if propagation
+|    conflicts, the literals assigned so far (plus the true one) form an implied clause. A
+|    shortened clause replaces the original; a unit is added at level 0. Returns FALSE if the
+|    problem was found to be unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::vivifyClause(CRef cr)
+{
+    // (the literals are copied: 'propagate()' may allocate clauses and move 'ca[cr]')
+    vec<Lit> lits, keep;
+    for (int i = 0; i < ca[cr].size(); i++)
+        lits.push(ca[cr][i]);
+
+    detachClause(cr, true);
+    trail_lim.push(trail.size());
+    for (int i = 0; i < lits.size(); i++){
+        Lit p = lits[i];
+        if (value(p) == l_False)
+            continue;
+        keep.push(p);
+        if (value(p) == l_True)
+            break;
+        uncheckedEnqueue(~p);
+        if (propagate() != CRef_Undef)
+            break;
+    }
+    cancelUntil(0);
+
+    Clause& c = ca[cr];
+    if (keep.size() == c.size()){
+        attachClause(cr);
+        return true; }
+
+    stats_vivify.clauses++;
+    stats_vivify.literals += c.size() - keep.size();
+
+    if (keep.size() > 0){
+        proof.add(keep);
+        proof.remove(c); }
+
+    if (keep.size() <= 1){
+        c.mark(1);
+        ca.free(cr);
+        if (keep.size() == 0)
+            return false;
+        uncheckedEnqueue(keep[0]);
+        return propagate() == CRef_Undef;
+    }
+
+    for (int i = 0; i < keep.size(); i++)
+        c[i] = keep[i];
+    c.shrink(c.size() - keep.size());
+    attachClause(cr);
+    return true;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  probe : (props : int64_t)  ->  [bool]
+|  
+|  Description:
+|    Failed-literal probing. Both polarities of every root of the binary implication graph (a
+|    literal that occurs in no binary clause, while its negation does) are assigned on a fresh
+|    decision level and propagated. A polarity that leads to a conflict is failed, and its
+|    negation is added as a unit. Literals implied by both polarities are added as units as well.
+|    Literals that were implied through a longer clause are recorded as hyper-binary resolvents
+|    '(~p | l)', which lets later probes and the search reach them with binary propagation only.
+|    Stops when 'props' propagations are used up. Returns FALSE if the problem was found to be
+|    unsatisfiable.
+|________________________________________________________________________________________________@*/
+bool Solver::probe(int64_t props)
+{
+    assert(decisionLevel() == 0);
+    if (!ok || propagate() != CRef_Undef)
+        return ok = false;
+
+    double start_time = cpuTime();
+    stats_probe.runs++;
+
+    vec<int> bin_occ(2*nVars(), 0);
+    for (int k = 0; k < 2; k++){
+        const vec<CRef>& cs = k == 0 ? clauses : learnts;
+        for (int i = 0; i < cs.size(); i++){
+            const Clause& c = ca[cs[i]];
+            if (c.size() == 2){
+                bin_occ[toInt(c[0])]++;
+                bin_occ[toInt(c[1])]++; } }
+    }
+
+    vec<Lit> roots;
+    for (int i = 0; i < bin_occ.size(); i++){
+        Lit p = toLit(i);
+        if (bin_occ[toInt(p)] == 0 && bin_occ[toInt(~p)] > 0)
+            roots.push(p);
+    }
+
+    uint64_t props_before = propagations;
+    vec<Lit> pos_implied, neg_implied, hbr, units;
+    for (int i = 0; i < roots.size() && (int64_t)(propagations - props_before) < props; i++){
+        Lit p = roots[i];
+        if (value(p) != l_Undef) continue;
+
+        units.clear();
+        hbr.clear();
+        if (!probeLit(p, pos_implied, hbr))
+            units.push(~p), proof.add(~p);
+        else if (!probeLit(~p, neg_implied, hbr))
+            units.push(p), proof.add(p);
+        else{
+            // Literals implied by both polarities:
+            for (int j = 0; j < pos_implied.size(); j++)
+                seen[var(pos_implied[j])] = 1 + sign(pos_implied[j]);
+            for (int j = 0; j < neg_implied.size(); j++)
+                if (seen[var(neg_implied[j])] == 1 + sign(neg_implied[j])){
+                    Lit l = neg_implied[j];
+                    units.push(l);
+                    if (proof.active()){
+                        // The unit is the resolvent of '(~p | l)' and '(p | l)':
+                        Lit pos[2] = { ~p, l }, neg[2] = { p, l };
+                        proof.add(pos, 2); proof.add(neg, 2);
+                        proof.add(l);
+                        proof.remove(pos, 2); proof.remove(neg, 2); }
+                }
+            for (int j = 0; j < pos_implied.size(); j++)
+                seen[var(pos_implied[j])] = 0;
+        }
+
+        for (int j = 0; j < units.size(); j++){
+            if (value(units[j]) == l_False)
+                return ok = false;
+            else if (value(units[j]) == l_Undef){
+                uncheckedEnqueue(units[j]);
+                stats_probe.literals++; }
+        }
+        if (propagate() != CRef_Undef)
+            return ok = false;
+
+        // Add the hyper-binary resolvents that are still relevant (pairs of literals):
+        vec<Lit>& bin = add_tmp;
+        for (int j = 0; j < hbr.size(); j += 2){
+            if (value(hbr[j]) != l_Undef || value(hbr[j+1]) != l_Undef) continue;
+            bin.clear();
+            bin.push(hbr[j]);
+            bin.push(hbr[j+1]);
+            proof.add(bin);
+            CRef cr = ca.alloc(bin, true);
+            learnts.push(cr);
+            attachClause(cr);
+            claBumpActivity(ca[cr]);
+            stats_probe.clauses++;
+        }
+    }
+
+    stats_probe.time += cpuTime() - start_time;
+    if (verbosity >= 2)
+        printf("|  Probing: %8d roots, %8" PRIu64 " units, %8" PRIu64 " binaries                      |\n",
+               roots.size(), stats_probe.literals, stats_probe.clauses);
+    return true;
+}
+
+
+// Assign 'p' on a new decision level and propagate. Returns FALSE on a conflict. Otherwise, the
+// implied literals are stored in 'implied' and up to 'probe_max_hbr' hyper-binary resolvents are
+// appended to 'hbr' as pairs of literals.
+bool Solver::probeLit(Lit p, vec<Lit>& implied, vec<Lit>& hbr)
+{
+    assert(decisionLevel() == 0);
+    assert(value(p) == l_Undef);
+
+    implied.clear();
+    trail_lim.push(trail.size());
+    uncheckedEnqueue(p);
+    bool no_conflict = propagate() == CRef_Undef;
+    if (no_conflict){
+        int added = 0;
+        for (int i = trail_lim[0] + 1; i < trail.size(); i++){
+            Lit q = trail[i];
+            implied.push(q);
+            CRef r = reason(var(q));
+            if (added < probe_max_hbr && r != CRef_Undef && (r == CRef_Lazy || ca[r].size() > 2)){
+                hbr.push(~p);
+                hbr.push(q);
+                added++;
+            }
+        }
+    }
+    cancelUntil(0);
+    return no_conflict;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -704,6 +1697,7 @@ lbool Solver::search(int curr_restarts) {
     int         conflictC = 0;
     vec<Lit>    learnt_clause;
     starts++;
+    TRACE_EVENT(trace, trace_restart, decisionLevel(), conflicts, (uint32_t)starts);
     int best_level;
     best_clause = CRef_Undef;
 
@@ -713,12 +1707,28 @@ lbool Solver::search(int curr_restarts) {
             // CONFLICT
             conflicts++; conflictC++;
 
+            if (confl == lazy_confl){
+                // An XOR row changed by elimination may conflict only below the current level:
+                const Clause& c = ca[confl];
+                int max_level = 0;
+                for (int i = 0; i < c.size(); i++)
+                    max_level = std::max(max_level, level(var(c[i])));
+                cancelUntil(max_level); }
+
             if (decisionLevel() == 0) return l_False;
 
+            if (assumps_one_level && decisionLevel() == 1 && assumptions.size() > 0){
+                // The assumptions (with what they imply) are contradictory:
+                analyzeFinal(confl, conflict);
+                return l_False; }
+
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
-            if (external_watcher)
-                external_watcher->notifyConflict(confl, learnt_clause);
+            TRACE_EVENT(trace, trace_conflict, decisionLevel(), conflicts, learnt_clause.size(), computeLBD(learnt_clause), backtrack_level);
+            if (external_watcher){
+                PhaseTimer timer(time_watcher, stats_timers);
+                external_watcher->notifyConflict(confl, learnt_clause); }
+            proof.add(learnt_clause);
             cancelUntil(backtrack_level);
 
             if (learnt_clause.size() == 1){
@@ -757,8 +1767,9 @@ lbool Solver::search(int curr_restarts) {
         }else{
 
             bool should_restart = false;
-            if (external_watcher)
-                should_restart = external_watcher->notifyDecision();
+            if (external_watcher){
+                PhaseTimer timer(time_watcher, stats_timers);
+                should_restart = external_watcher->notifyDecision(); }
 
             // NO CONFLICT
             if (should_restart || !withinBudget()){
@@ -767,6 +1778,16 @@ lbool Solver::search(int curr_restarts) {
                 cancelUntil(0);
                 return l_Undef; }
 
+            // Periodically pause the search and simplify at the root level:
+            if (use_inprocessing && conflicts >= next_inprocess){
+                cancelUntil(0);
+                if (!inprocess())
+                    return l_False;
+            }
+
+            if (checkpoint_requested)
+                checkpoint();
+
             // Simplify the set of problem clauses:
             if (decisionLevel() == 0 && !simplify())
                 return l_False;
@@ -775,8 +1796,22 @@ lbool Solver::search(int curr_restarts) {
                 // Reduce the set of learnt clauses:
                 reduceDB();
 
+            if (assumps_one_level && decisionLevel() == 0 && assumptions.size() > 0){
+                // Perform all user provided assumptions on one level, then propagate them together:
+                newDecisionLevel();
+                for (int i = 0; i < assumptions.size(); i++){
+                    Lit p = assumptions[i];
+                    if (value(p) == l_False){
+                        analyzeFinal(~p, conflict);
+                        return l_False;
+                    }else if (value(p) == l_Undef)
+                        uncheckedEnqueue(p);
+                }
+                continue;
+            }
+
             Lit next = lit_Undef;
-            while (decisionLevel() < assumptions.size()){
+            while (!assumps_one_level && decisionLevel() < assumptions.size()){
                 // Perform user provided assumption:
                 Lit p = assumptions[decisionLevel()];
                 if (value(p) == l_True){
@@ -796,14 +1831,20 @@ lbool Solver::search(int curr_restarts) {
                 decisions++;
                 next = pickBranchLit();
 
-                if (next == lit_Undef)
+                if (next == lit_Undef){
                     // Model found:
-                    return l_True;
+                    if (enumeration == NULL)
+                        return l_True;
+                    lbool ret = blockModel();
+                    if (ret != l_Undef) return ret;
+                    continue;
+                }
             }
 
             // Increase decision level and enqueue 'next'
             newDecisionLevel();
             uncheckedEnqueue(next);
+            TRACE_EVENT(trace, trace_decision, decisionLevel(), conflicts, toInt(next));
         }
     }
 }
@@ -860,6 +1901,18 @@ lbool Solver::solve_()
 
     solves++;
 
+    // Continue from the levels kept by the previous call, as far as they were made by the same
+    // assumptions:
+    int reuse = 0;
+    while (reuse < kept_assumps.size() && reuse < assumptions.size() && kept_assumps[reuse] == assumptions[reuse])
+        reuse++;
+    if (assumps_one_level)
+        // The single assumption level can only be reused as a whole:
+        reuse = reuse > 0 && reuse == kept_assumps.size() && reuse == assumptions.size();
+    cancelUntil(reuse);
+    kept_assumps.clear();
+    reused_levels += reuse;
+
     max_learnts = nClauses() * learntsize_factor;
     if (max_learnts < min_learnts_lim)
         max_learnts = min_learnts_lim;
@@ -868,6 +1921,12 @@ lbool Solver::solve_()
     learntsize_adjust_cnt     = (int)learntsize_adjust_confl;
     lbool   status            = l_Undef;
 
+    if (use_inprocessing && inprocess_confl == 0){
+        inprocess_confl = inprocess_interval;
+        next_inprocess  = conflicts + inprocess_interval;
+        inprocess_props = propagations;
+    }
+
     if (verbosity >= 1){
         printf("============================[ Search Statistics ]==============================\n");
         printf("| Conflicts |          ORIGINAL         |          LEARNT          | Progress |\n");
@@ -893,14 +1952,25 @@ lbool Solver::solve_()
         for (int i = 0; i < nVars(); i++) model[i] = value(i);
     }else if (status == l_False && conflict.size() == 0)
         ok = false;
-
-    cancelUntil(0);
+    TRACE_EVENT(trace, trace_solve, decisionLevel(), conflicts, toInt(status), assumptions.size());
+
+    // The first levels are made by the assumptions (in order); keep them for the next call:
+    if (reuse_trail && ok){
+        // (the single assumption level is only complete and consistent after a model was found)
+        int keep = !assumps_one_level ? std::min(decisionLevel(), assumptions.size())
+                 : status == l_True && assumptions.size() > 0 ? assumptions.size() : 0;
+        cancelUntil(assumps_one_level ? (keep > 0) : keep);
+        for (int i = 0; i < keep; i++)
+            kept_assumps.push(assumptions[i]);
+    }else
+        cancelUntil(0);
     return status;
 }
 
 
 bool Solver::implies(const vec<Lit>& assumps, vec<Lit>& out)
 {
+    cancelKept();
     trail_lim.push(trail.size());
     for (int i = 0; i < assumps.size(); i++){
         Lit a = assumps[i];
@@ -925,6 +1995,311 @@ bool Solver::implies(const vec<Lit>& assumps, vec<Lit>& out)
     return ret;
 }
 
+//=================================================================================================
+// Core minimization:
+
+
+// Keep the literals of 'assumps' (in their order) whose negation is in 'conflict':
+void Solver::coreOf(const vec<Lit>& assumps, vec<Lit>& out_core)
+{
+    // (duplicates are removed by literal: both 'p' and '~p' may be assumed, 'seen' marks each sign)
+    out_core.clear();
+    for (int i = 0; i < assumps.size(); i++){
+        Lit  p    = assumps[i];
+        char mark = 1 + sign(p);
+        if (conflict.has(~p) && !(seen[var(p)] & mark)){
+            seen[var(p)] |= mark;
+            out_core.push(p); } }
+    for (int i = 0; i < out_core.size(); i++)
+        seen[var(out_core[i])] = 0;
+}
+
+
+// Deletion-based shrinking: each check drops one untested literal of the core and calls
+// 'solveLimited()' with at most 'check_conflicts' conflicts. If the rest is still unsatisfiable, the
+// core is replaced by the (often much smaller) final conflict of that call; otherwise the literal is
+// necessary (or undecided within the budget) and kept. The literals known to be necessary stay at
+// the front of the assumptions, so with 'reuse_trail' their levels are shared by the next check,
+// and the learnt clauses of the checks stay in the solver as for any other incremental call.
+//
+// With 'jobs > 1', the next 'jobs' literals are checked at once: one check runs in this solver,
+// the others in forked children (copies of the solver) whose learnt clauses are lost.
+lbool Solver::minimizeCore(const vec<Lit>& assumps, vec<Lit>& out_core, int64_t check_conflicts, int jobs)
+{
+    lbool status = solveLimited(assumps);
+    if (status != l_False){
+        out_core.clear();
+        return status; }
+    coreOf(assumps, out_core);
+
+    int64_t         saved_conflicts    = conflict_budget;
+    int64_t         saved_propagations = propagation_budget;
+    int             saved_learnts_lim  = min_learnts_lim;
+    int             fixed              = 0;   // 'out_core[0..fixed)' are necessary (or could not be removed).
+    vec<lbool>      results;
+    vec<vec<Lit> >  cores;
+    vec<Lit>        shrunk;
+    while (ok && fixed < out_core.size() && !asynch_interrupt){
+        int checks = std::min(jobs, out_core.size() - fixed);
+        checkCore(out_core, fixed, checks, check_conflicts, results, cores);
+        core_checks += checks;
+
+        // Continue with the smallest unsatisfiable candidate:
+        int best = -1;
+        for (int j = 0; j < checks; j++)
+            if (results[j] == l_False && (best < 0 || cores[j].size() < cores[best].size()))
+                best = j;
+        if (best < 0){
+            fixed += checks;
+            continue; }
+
+        // A literal that is necessary in the old core is necessary in any subset of it, so the
+        // literals of the satisfiable (or undecided) candidates stay fixed if they remain:
+        conflict.clear();
+        for (int i = 0; i < cores[best].size(); i++)
+            conflict.insert(cores[best][i]);
+        shrunk.clear();
+        for (int i = 0; i < fixed + checks; i++)
+            if (conflict.has(~out_core[i]) && (i < fixed || results[i - fixed] != l_False))
+                shrunk.push(out_core[i]);
+        int new_fixed = shrunk.size();
+        for (int i = fixed; i < out_core.size(); i++)
+            if (conflict.has(~out_core[i]) && (i >= fixed + checks || results[i - fixed] == l_False))
+                shrunk.push(out_core[i]);
+        shrunk.moveTo(out_core);
+        fixed = new_fixed;
+    }
+
+    conflict_budget    = saved_conflicts;
+    propagation_budget = saved_propagations;
+    min_learnts_lim    = saved_learnts_lim;
+    if (!ok)
+        // The clauses alone are unsatisfiable:
+        out_core.clear();
+    conflict.clear();
+    for (int i = 0; i < out_core.size(); i++)
+        conflict.insert(~out_core[i]);
+    return l_False;
+}
+
+
+// Check the candidates 'core' without 'core[fixed+j]' for 'j < checks', giving their results and
+// (for the unsatisfiable ones) their final conflicts. The first one is checked by this solver, the
+// others in forked children; a failed fork or a child that died counts as undecided.
+void Solver::checkCore(const vec<Lit>& core, int fixed, int checks, int64_t check_conflicts,
+                       vec<lbool>& results, vec<vec<Lit> >& cores)
+{
+    vec<Lit>   cand;
+    vec<pid_t> pids;
+    vec<int>   fds;
+
+    // Keep the learnt clauses of the previous checks: 'solve_()' resets the learnt clause limit to a
+    // fraction of the problem clauses, and above it 'reduceDB()' (which keeps the binary clauses)
+    // would run at every decision:
+    min_learnts_lim = std::max(min_learnts_lim, std::max((int)max_learnts, learnts.size()));
+    budgetOff();
+    setConfBudget(check_conflicts);
+
+    fflush(stdout);
+    for (int j = 1; j < checks; j++){
+        int   fd[2];
+        pid_t pid = -1;
+        if (pipe(fd) == 0 && (pid = fork()) < 0){
+            close(fd[0]); close(fd[1]); }
+        if (pid == 0){
+            // Only the solver thread exists in the child: detach what belongs to the other threads
+            // and end with '_exit()' so that no destructors run.
+            close(fd[0]);
+            for (int i = 0; i < fds.size(); i++) if (fds[i] >= 0) close(fds[i]);
+            external_watcher.release();
+            proof.abandon();
+            trace.abandon();
+            verbosity       = 0;
+            checkpoint_file = NULL;
+
+            for (int i = 0; i < core.size(); i++)
+                if (i != fixed + j) cand.push(core[i]);
+            lbool r = solveLimited(cand);
+
+            // Reply: the result, then the conflict literals:
+            vec<int> out;
+            out.push(toInt(r));
+            for (int i = 0; r == l_False && i < conflict.size(); i++)
+                out.push(toInt(conflict[i]));
+            const char* data = (const char*)&out[0];
+            for (size_t done = 0, size = out.size() * sizeof(int); done < size; ){
+                ssize_t n = write(fd[1], data + done, size - done);
+                if (n <= 0) break;
+                done += n; }
+            _exit(0);
+        }
+        if (pid > 0) close(fd[1]);
+        pids.push(pid);
+        fds .push(pid > 0 ? fd[0] : -1);
+    }
+
+    results.clear();
+    cores.clear();
+    cores.growTo(checks);
+    for (int i = 0; i < core.size(); i++)
+        if (i != fixed) cand.push(core[i]);
+    results.push(solveLimited(cand));
+    conflict.toVec().copyTo(cores[0]);
+
+    for (int j = 1; j < checks; j++){
+        vec<int> in;
+        if (pids[j-1] > 0){
+            char    buf[4096];
+            int     len = 0;
+            ssize_t n;
+            while ((n = read(fds[j-1], buf + len, sizeof(buf) - len)) > 0){
+                len += n;
+                int whole = len / sizeof(int) * sizeof(int);
+                for (int i = 0; i < whole; i += sizeof(int)){
+                    int x; memcpy(&x, buf + i, sizeof(int)); in.push(x); }
+                memmove(buf, buf + whole, len - whole);
+                len -= whole; }
+            close(fds[j-1]);
+            waitpid(pids[j-1], NULL, 0);
+        }
+        results.push(in.size() > 0 ? toLbool(in[0]) : l_Undef);
+        for (int i = 1; i < in.size(); i++)
+            cores[j].push(toLit(in[i]));
+    }
+}
+
+
+//=================================================================================================
+// Model enumeration:
+
+
+// The models are enumerated by a single call of 'solve_()': each model is blocked by a clause and
+// the search continues after backjumping like after a conflict, without restarting and keeping
+// the learnt clauses. The blocking clauses contain the negation of an activation literal that is
+// assumed during the enumeration and released afterwards.
+lbool Solver::enumerate(const vec<Lit>& assumps, const vec<Var>& project,
+                        const std::function<bool(const vec<Lit>&)>& on_model, uint64_t max_models)
+{
+    Enumeration e;
+    e.on_model   = &on_model;
+    e.max_models = max_models;
+    e.models     = 0;
+    if (project.size() > 0)
+        project.copyTo(e.project);
+    else
+        for (Var v = 0; v < nVars(); v++)
+            if (decision[v]) e.project.push(v);
+
+    e.act = mkLit(newVar(l_Undef, false));
+    e.projected.growTo(nVars(), 0);
+    for (int i = 0; i < e.project.size(); i++)
+        e.projected[e.project[i]] = 1;
+
+    // Decide the projected variables before all others (by raising their precedence):
+    vec<int> saved_prec;
+    if (enum_proj_first){
+        int max_prec = INT32_MIN, min_proj = INT32_MAX;
+        for (Var v = 0; v < nVars(); v++){
+            saved_prec.push(user_prec[v]);
+            if (!e.projected[v]) max_prec = std::max(max_prec, user_prec[v]);
+            else                 min_proj = std::min(min_proj, user_prec[v]); }
+        if (min_proj <= max_prec){
+            for (int i = 0; i < e.project.size(); i++)
+                user_prec[e.project[i]] += max_prec - min_proj + 1;
+            rebuildOrderHeap(); }
+    }
+
+    assumps.copyTo(assumptions);
+    assumptions.push(e.act);
+    enumeration = &e;
+    lbool status = solve_();
+    enumeration = NULL;
+
+    if (enum_proj_first){
+        for (Var v = 0; v < saved_prec.size(); v++)
+            user_prec[v] = saved_prec[v];
+        rebuildOrderHeap(); }
+
+    // The final conflict of an exhausted enumeration contains the activation literal; without it
+    // (and without models) it is the conflict in terms of the user's assumptions:
+    if (status == l_False && e.models > 0)
+        conflict.clear();
+    releaseVar(~e.act);
+    return status;
+}
+
+
+// Pass the current (complete) assignment to the enumeration and block it. Returns 'l_Undef' if the
+// search should continue, 'l_True' if the enumeration stops and 'l_False' if all models have been
+// enumerated (i.e. the blocking clause is false under the assumptions alone).
+lbool Solver::blockModel()
+{
+    Enumeration& e = *enumeration;
+
+    // (non-decision variables may be left unassigned, they are not part of the model)
+    e.model.clear();
+    for (int i = 0; i < e.project.size(); i++)
+        if (value(e.project[i]) != l_Undef)
+            e.model.push(mkLit(e.project[i], value(e.project[i]) == l_False));
+    e.models++;
+    if (!(*e.on_model)(e.model) || (e.max_models > 0 && e.models >= e.max_models))
+        return l_True;
+
+    // Blocking clause: the negated decisions above the assumptions up to the last level that assigns
+    // a projected variable, if they are all projected (then they imply the projected model, as with
+    // 'enum_proj_first'), or else the whole negated projected model. Projected variables assigned by
+    // the assumptions are left out.
+    int assump_levels = assumps_one_level ? (assumptions.size() > 0) : assumptions.size();
+    int top           = assump_levels;
+    for (int i = 0; i < e.model.size(); i++)
+        top = std::max(top, level(var(e.model[i])));
+
+    bool decided = true;
+    for (int l = assump_levels; l < top; l++)
+        if (!e.projected[var(trail[trail_lim[l]])])
+            decided = false;
+
+    vec<Lit>& block = add_tmp;
+    block.clear();
+    block.push(~e.act);
+    if (decided)
+        for (int l = assump_levels; l < top; l++)
+            block.push(~trail[trail_lim[l]]);
+    else
+        for (int i = 0; i < e.model.size(); i++)
+            if (level(var(e.model[i])) > assump_levels)
+                block.push(~e.model[i]);
+
+    if (block.size() == 1){
+        // Nothing is left to block:
+        conflict.clear();
+        conflict.insert(~e.act);
+        return l_False; }
+
+    // (the activation literal makes the clause redundant by RAT)
+    if (proof.active()) proof.add(block);
+
+    // Watch the two literals of the highest levels and backjump, like with a learnt clause:
+    for (int i = 1; i < block.size(); i++)
+        if (level(var(block[i])) > level(var(block[0]))) std::swap(block[0], block[i]);
+    for (int i = 2; i < block.size(); i++)
+        if (level(var(block[i])) > level(var(block[1]))) std::swap(block[1], block[i]);
+
+    int  lev0 = level(var(block[0])), lev1 = level(var(block[1]));
+    CRef cr   = ca.alloc(block, false);
+    clauses.push(cr);
+    if (lev0 > lev1){
+        cancelUntil(lev1);
+        attachClause(cr);
+        uncheckedEnqueue(block[0], cr);
+    }else{
+        cancelUntil(lev0 - 1);
+        attachClause(cr); }
+
+    return l_Undef;
+}
+
+
 //=================================================================================================
 // Writing CNF to DIMACS:
 // 
@@ -963,6 +2338,8 @@ void Solver::toDimacs(const char *file, const vec<Lit>& assumps)
 
 void Solver::toDimacs(FILE* f, const vec<Lit>& assumps)
 {
+    cancelKept();
+
     // Handle case when solver is in contradictory state:
     if (!ok){
         fprintf(f, "p cnf 1 2\n1 0\n-1 0\n");
@@ -1003,6 +2380,360 @@ void Solver::toDimacs(FILE* f, const vec<Lit>& assumps)
 }
 
 
+void Solver::toBinaryCnf(const char* file, const vec<Lit>& assumps, bool varint)
+{
+    FILE* f = fopen(file, "wb");
+    if (f == NULL)
+        fprintf(stderr, "could not open file %s\n", file), exit(1);
+    toBinaryCnf(f, assumps, varint);
+    fclose(f);
+}
+
+
+// Writes the same formula as 'toDimacs()' (with the same variable numbering).
+void Solver::toBinaryCnf(FILE* f, const vec<Lit>& assumps, bool varint)
+{
+    cancelKept();
+    vec<Lit> lits;
+    vec<int> offsets;
+    offsets.push(0);
+
+    // Handle case when solver is in contradictory state:
+    if (!ok){
+        lits.push(mkLit(0));  offsets.push(lits.size());
+        lits.push(~mkLit(0)); offsets.push(lits.size());
+        writeBinaryCnf(f, 1, lits, offsets, varint);
+        return; }
+
+    vec<Var> map; Var max = 0;
+    for (int i = 0; i < clauses.size(); i++)
+        if (!satisfied(ca[clauses[i]])){
+            Clause& c = ca[clauses[i]];
+            for (int j = 0; j < c.size(); j++)
+                if (value(c[j]) != l_False)
+                    mapVar(var(c[j]), map, max);
+        }
+
+    // Assumptions are added as unit clauses:
+    for (int i = 0; i < assumps.size(); i++){
+        assert(value(assumps[i]) != l_False);
+        lits.push(mkLit(mapVar(var(assumps[i]), map, max), sign(assumps[i])));
+        offsets.push(lits.size());
+    }
+
+    for (int i = 0; i < clauses.size(); i++)
+        if (!satisfied(ca[clauses[i]])){
+            Clause& c = ca[clauses[i]];
+            for (int j = 0; j < c.size(); j++)
+                if (value(c[j]) != l_False)
+                    lits.push(mkLit(mapVar(var(c[j]), map, max), sign(c[j])));
+            offsets.push(lits.size());
+        }
+
+    writeBinaryCnf(f, max, lits, offsets, varint);
+
+    if (verbosity > 0)
+        printf("Wrote binary CNF with %d variables and %d clauses.\n", max, offsets.size() - 1);
+}
+
+
+// Top-level assignments implied by propagation are not in the proof. They have to be added as units
+// before a clause they depend on (e.g. a satisfied one) is deleted:
+void Solver::logUnits()
+{
+    if (!proof.active()) return;
+    int top = decisionLevel() == 0 ? trail.size() : trail_lim[0];
+    for (; proof_units < top; proof_units++)
+        proof.add(trail[proof_units]);
+}
+
+
+bool Solver::closeProof()
+{
+    if (!ok && proof.active()){
+        vec<Lit> empty;
+        proof.add(empty); }
+    return proof.close();
+}
+
+
+//=================================================================================================
+// Checkpoints:
+
+
+bool Solver::saveCheckpoint(const char* file)
+{
+    // Write to a temporary file first, so an interrupted write never destroys the previous checkpoint:
+    vec<char> tmp;
+    for (int i = 0; file[i] != 0; i++) tmp.push(file[i]);
+    const char* suffix = ".tmp";
+    for (int i = 0; i <= 4; i++) tmp.push(suffix[i]);
+
+    FILE* f = fopen(&tmp[0], "wb");
+    if (f == NULL) return false;
+
+    fwrite(ckpt_magic, 1, sizeof(ckpt_magic), f);
+    bcnfPut32(f, ckpt_version);
+    writeState(f);
+
+    bool ok_ = !ferror(f);
+    ok_ = (fflush(f) == 0) && ok_;
+    ok_ = (fsync(fileno(f)) == 0) && ok_;
+    ok_ = (fclose(f) == 0) && ok_;
+    if (ok_ && rename(&tmp[0], file) == 0)
+        return true;
+    ::remove(&tmp[0]);
+    return false;
+}
+
+
+bool Solver::loadCheckpoint(const char* file)
+{
+    assert(nVars() == 0);
+
+    FILE* f = fopen(file, "rb");
+    if (f == NULL) return false;
+
+    char             magic[sizeof(ckpt_magic)];
+    CheckpointReader in(f);
+    bool             valid = fread(magic, 1, sizeof(magic), f) == sizeof(magic)
+                          && memcmp(magic, ckpt_magic, sizeof(magic)) == 0
+                          && in.get32() == ckpt_version
+                          && readState(f);
+    fclose(f);
+    return valid;
+}
+
+
+// The child process works on a copy-on-write snapshot of the address space, so the search only
+// pays for the pages it modifies while the checkpoint is being written.
+bool Solver::checkpoint()
+{
+    checkpoint_requested = false;
+    if (checkpoint_file == NULL)
+        return false;
+
+    // Skip this checkpoint if the previous one is still being written:
+    if (checkpoint_pid > 0){
+        if (waitpid(checkpoint_pid, NULL, WNOHANG) == 0)
+            return false;
+        checkpoint_pid = 0; }
+
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0)
+        return false;
+    if (pid == 0)
+        // Note: '_exit()' so that the child does not run destructors or flush the parent's buffers.
+        _exit(saveCheckpoint(checkpoint_file) ? 0 : 1);
+
+    checkpoint_pid = pid;
+    return true;
+}
+
+
+void Solver::writeState(FILE* f)
+{
+    // Scalars:
+    putc(ok, f);
+    ckptPutDouble(f, var_inc);
+    ckptPutDouble(f, cla_inc);
+    ckptPutDouble(f, max_learnts);
+    ckptPutDouble(f, learntsize_adjust_confl);
+    bcnfPut32    (f, learntsize_adjust_cnt);
+    ckptPutDouble(f, random_seed);
+    bcnfPut64    (f, solves);
+    bcnfPut64    (f, starts);
+    bcnfPut64    (f, decisions);
+    bcnfPut64    (f, rnd_decisions);
+    bcnfPut64    (f, propagations);
+    bcnfPut64    (f, conflicts);
+    bcnfPut64    (f, next_inprocess);
+    ckptPutDouble(f, inprocess_confl);
+    bcnfPut64    (f, inprocess_props);
+    bcnfPut32    (f, ckpt_tag);
+
+    // Variables:
+    bcnfPut32(f, nVars());
+    for (Var v = 0; v < nVars(); v++){
+        ckptPutDouble(f, activity[v]);
+        putc(polarity[v], f);
+        putc(toInt(user_pol[v]), f);
+        bcnfPut32(f, user_prec[v]);
+        putc(decision[v], f); }
+    bcnfPut32(f, ckpt_tag);
+
+    // Top-level assignments:
+    int top = decisionLevel() == 0 ? trail.size() : trail_lim[0];
+    bcnfPutVarint(f, top);
+    for (int i = 0; i < top; i++)
+        bcnfPutVarint(f, toInt(trail[i]));
+    bcnfPut32(f, ckpt_tag);
+
+    // Clauses (removed ones may still be listed while simplification is running):
+    for (int k = 0; k < 2; k++){
+        const vec<CRef>& cs = k == 0 ? clauses : learnts;
+        int n = 0;
+        for (int i = 0; i < cs.size(); i++)
+            n += ca[cs[i]].mark() == 0;
+        bcnfPutVarint(f, n);
+        for (int i = 0; i < cs.size(); i++){
+            Clause& c = ca[cs[i]];
+            if (c.mark() != 0) continue;
+            bcnfPutVarint(f, c.size());
+            if (c.learnt())
+                ckptPutFloat(f, c.activity());
+            for (int j = 0; j < c.size(); j++)
+                bcnfPutVarint(f, toInt(c[j]));
+        }
+        bcnfPut32(f, ckpt_tag);
+    }
+
+    // At-most constraints:
+    bcnfPutVarint(f, atmosts.size());
+    for (int i = 0; i < atmosts.size(); i++){
+        const AtMost& a = atmosts[i];
+        bcnfPutVarint(f, a.size);
+        bcnfPutVarint(f, a.k);
+        for (int j = 0; j < a.size; j++)
+            bcnfPutVarint(f, toInt(atmost_lits[a.lits + j]));
+    }
+    bcnfPut32(f, ckpt_tag);
+
+    // XOR constraints (the rows of the matrix, as literals whose XOR is true):
+    bcnfPutVarint(f, xor_basic.size());
+    for (int i = 0; i < xor_basic.size(); i++){
+        const uint64_t* row = xor_rows[i];
+        int size = 0;
+        for (int j = 0; j < xor_rows.stride(); j++)
+            size += bitCount(row[j]);
+        bcnfPutVarint(f, size);
+        bool first = true;
+        for (int j = 0; j < xor_rows.stride(); j++)
+            for (uint64_t m = row[j]; m != 0; m &= m - 1){
+                Lit p = mkLit(xor_var[j*64 + bitFirst(m)], first && !xor_rhs[i]);
+                bcnfPutVarint(f, toInt(p));
+                first = false; }
+    }
+    bcnfPut32(f, ckpt_tag);
+}
+
+
+bool Solver::readState(FILE* f)
+{
+    CheckpointReader in(f);
+
+    // Scalars:
+    bool ok_                = in.get8() != 0;
+    var_inc                 = in.getDouble();
+    cla_inc                 = in.getDouble();
+    max_learnts             = in.getDouble();
+    learntsize_adjust_confl = in.getDouble();
+    learntsize_adjust_cnt   = (int)in.get32();
+    random_seed             = in.getDouble();
+    solves                  = in.get64();
+    starts                  = in.get64();
+    decisions               = in.get64();
+    rnd_decisions           = in.get64();
+    propagations            = in.get64();
+    conflicts               = in.get64();
+    next_inprocess          = in.get64();
+    inprocess_confl         = in.getDouble();
+    inprocess_props         = in.get64();
+    if (!in.endSection() || random_seed <= 0) return false;
+
+    // Variables:
+    int vars = (int)in.get32();
+    if (vars < 0) return false;
+    for (Var v = 0; v < vars && in.ok; v++){
+        double act  = in.getDouble();
+        char   pol  = (char)in.get8();
+        lbool  upol = toLbool(in.get8());
+        int    prec = (int)in.get32();
+        bool   dvar = in.get8() != 0;
+        newVar(upol, dvar);
+        activity [v] = act;
+        polarity [v] = pol;
+        user_prec[v] = prec;
+    }
+    if (!in.endSection()) return false;
+    rebuildOrderHeap();
+
+    // Top-level assignments (enqueued after the clauses are attached):
+    vec<Lit> units;
+    int      n_units = (int)in.getVarint();
+    for (int i = 0; i < n_units && in.ok; i++){
+        int x = (int)in.getVarint();
+        if (x >= 2*vars) return false;
+        units.push(toLit(x)); }
+    if (!in.endSection()) return false;
+
+    // Clauses:
+    vec<Lit> lits;
+    for (int k = 0; k < 2; k++){
+        bool learnt = k == 1;
+        int  n      = (int)in.getVarint();
+        for (int i = 0; i < n && in.ok; i++){
+            int   size = (int)in.getVarint();
+            float act  = learnt ? in.getFloat() : 0;
+            if (size < 2) return false;
+            lits.clear();
+            for (int j = 0; j < size; j++){
+                int x = (int)in.getVarint();
+                if (!in.ok || x >= 2*vars) return false;
+                lits.push(toLit(x)); }
+
+            CRef cr = ca.alloc(lits, learnt);
+            if (learnt){
+                ca[cr].activity() = act;
+                learnts.push(cr);
+            }else
+                clauses.push(cr);
+            attachClause(cr);
+        }
+        if (!in.endSection()) return false;
+    }
+
+    // At-most constraints (counted when the units are propagated):
+    int n_atmosts = (int)in.getVarint();
+    for (int i = 0; i < n_atmosts && in.ok; i++){
+        int size = (int)in.getVarint();
+        int k    = (int)in.getVarint();
+        if (k < 1 || k >= size) return false;
+        lits.clear();
+        for (int j = 0; j < size; j++){
+            int x = (int)in.getVarint();
+            if (!in.ok || x >= 2*vars) return false;
+            lits.push(toLit(x)); }
+        attachAtMost(lits, k);
+    }
+    if (!in.endSection()) return false;
+
+    // XOR constraints:
+    int n_xors = (int)in.getVarint();
+    for (int i = 0; i < n_xors && in.ok; i++){
+        int size = (int)in.getVarint();
+        lits.clear();
+        for (int j = 0; j < size; j++){
+            int x = (int)in.getVarint();
+            if (!in.ok || x >= 2*vars) return false;
+            lits.push(toLit(x)); }
+        addXor(lits);
+    }
+    if (!in.endSection()) return false;
+
+    ok = ok_;
+    for (int i = 0; ok && i < units.size(); i++)
+        if (value(units[i]) == l_False)
+            ok = false;
+        else if (value(units[i]) == l_Undef)
+            uncheckedEnqueue(units[i]);
+    if (ok && propagate() != CRef_Undef)
+        ok = false;
+    return true;
+}
+
+
 void Solver::printStats() const
 {
     double cpu_time = cpuTime();
@@ -1012,11 +2743,74 @@ void Solver::printStats() const
     printf("decisions             : %-12" PRIu64 "   (%4.2f %% random) (%.0f /sec)\n", decisions, (float)rnd_decisions*100 / (float)decisions, decisions   /cpu_time);
     printf("propagations          : %-12" PRIu64 "   (%.0f /sec)\n", propagations, propagations/cpu_time);
     printf("conflict literals     : %-12" PRIu64 "   (%4.2f %% deleted)\n", tot_literals, (max_literals - tot_literals)*100 / (double)max_literals);
+    if (inprocessings > 0){
+        printf("inprocessing          : %-12" PRIu64 "   (rounds)\n", inprocessings);
+        printf("  learnt subsumption  : %-12" PRIu64 "   (%" PRIu64 " runs, %.2f s)\n", stats_subsume.clauses, stats_subsume.runs, stats_subsume.time);
+        if (stats_vivify.runs > 0)
+        printf("  vivified learnts    : %-12" PRIu64 "   (%" PRIu64 " literals removed, %.2f s)\n", stats_vivify.clauses, stats_vivify.literals, stats_vivify.time);
+        if (stats_elim.runs > 0)
+        printf("  re-eliminated vars  : %-12" PRIu64 "   (%" PRIu64 " runs, %.2f s)\n", stats_elim.clauses, stats_elim.runs, stats_elim.time);
+    }
+    // (also before the search, without inprocessing rounds)
+    if (stats_probe.runs > 0)
+        printf("probing               : %-12" PRIu64 "   (%" PRIu64 " units, %" PRIu64 " binaries, %.2f s)\n", stats_probe.runs, stats_probe.literals, stats_probe.clauses, stats_probe.time);
+    if (reused_levels > 0)
+        printf("reused levels         : %-12" PRIu64 "   (assumption levels kept between calls)\n", reused_levels);
+    if (core_checks > 0)
+        printf("core checks           : %-12" PRIu64 "   (core minimization)\n", core_checks);
     if (mem_used != 0) printf("Memory used           : %.2f MB\n", mem_used);
     printf("CPU time              : %g s\n", cpu_time);
 }
 
 
+static void addInprocessStats(SolverStats& out, const char* name, const Solver::InprocessStats& st)
+{
+    std::string prefix = std::string("inprocess.") + name;
+    out.add((prefix + ".runs").c_str(), st.runs);
+    out.add((prefix + ".clauses").c_str(), st.clauses);
+    out.add((prefix + ".literals").c_str(), st.literals);
+    out.add((prefix + ".cpu").c_str(), st.time);
+}
+
+
+void Solver::collectStats(SolverStats& out) const
+{
+    out.add("problem.vars", (uint64_t)nVars());
+    out.add("problem.clauses", (uint64_t)nClauses());
+    out.add("problem.learnts", (uint64_t)nLearnts());
+
+    out.add("search.solves", solves);
+    out.add("search.restarts", starts);
+    out.add("search.decisions", decisions);
+    out.add("search.random_decisions", rnd_decisions);
+    out.add("search.propagations", propagations);
+    out.add("search.conflicts", conflicts);
+    out.add("search.conflict_literals", tot_literals);
+    out.add("search.minimized_literals", max_literals - tot_literals);
+    out.add("search.reused_levels", reused_levels);
+    out.add("search.core_checks", core_checks);
+
+    out.add("propagate.watcher_visits", watcher_visits);
+    out.add("propagate.blocker_hits", blocker_hits);
+    out.add("propagate.clause_visits", clause_visits);
+
+    out.add("inprocess.rounds", inprocessings);
+    addInprocessStats(out, "subsume", stats_subsume);
+    addInprocessStats(out, "vivify", stats_vivify);
+    addInprocessStats(out, "probe", stats_probe);
+    addInprocessStats(out, "elim", stats_elim);
+
+    out.add("time.propagate", time_propagate);
+    out.add("time.analyze", time_analyze);
+    out.add("time.reduce_db", time_reduce);
+    out.add("time.simplify", time_simplify);
+    out.add("time.garbage_collect", time_gc);
+    out.add("time.external_watcher", time_watcher);
+    out.add("time.cpu", cpuTime());
+    out.add("memory.peak_mb", memUsedPeak());
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
@@ -1040,7 +2834,7 @@ void Solver::relocAll(ClauseAllocator& to)
 
         // Note: it is not safe to call 'locked()' on a relocated clause. This is why we keep
         // 'dangling' reasons here. It is safe and does not hurt.
-        if (reason(v) != CRef_Undef && (ca[reason(v)].reloced() || locked(ca[reason(v)]))){
+        if (reason(v) != CRef_Undef && reason(v) != CRef_Lazy && (ca[reason(v)].reloced() || locked(ca[reason(v)]))){
             assert(!isRemoved(reason(v)));
             ca.reloc(vardata[v].reason, to);
         }
@@ -1067,11 +2861,16 @@ void Solver::relocAll(ClauseAllocator& to)
 
     // Relocate best_clause if it's set
     if (best_clause != CRef_Undef) ca.reloc(best_clause, to);  
+
+    // (the last conflict clause of an at-most constraint is not needed any more)
+    lazy_confl = CRef_Undef;
 }
 
 
 void Solver::garbageCollect()
 {
+    PhaseTimer timer(time_gc, stats_timers, true);
+
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted()); 
@@ -21,11 +21,18 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #ifndef Minisat_Solver_h
 #define Minisat_Solver_h
 
+#include <sys/types.h>
+#include <functional>
+
 #include "src/mtl/Vec.h"
 #include "src/mtl/Heap.h"
 #include "src/mtl/IntMap.h"
+#include "src/mtl/BitMatrix.h"
 #include "src/core/SolverTypes.h"
 #include "src/utils/ExternalWatcher.h" // Include the new header
+#include "src/utils/DratWriter.h"
+#include "src/utils/Stats.h"
+#include "src/utils/Trace.h"
 
 
 namespace Minisat {
@@ -43,8 +50,8 @@ public:
 
     // Problem specification:
     //
-    Var     newVar    (lbool upol = l_Undef, bool dvar = true); // Add a new variable with parameters specifying variable mode.
-    void    releaseVar(Lit l);                                  // Make literal true and promise to never refer to variable again.
+    virtual Var  newVar    (lbool upol = l_Undef, bool dvar = true); // Add a new variable with parameters specifying variable mode.
+    virtual void releaseVar(Lit l);                             // Make literal true and promise to never refer to variable again.
 
     bool    addClause (const vec<Lit>& ps);                     // Add a clause to the solver. 
     bool    addEmptyClause();                                   // Add the empty clause, making the solver contradictory.
@@ -54,6 +61,18 @@ public:
     bool    addClause (Lit p, Lit q, Lit r, Lit s);             // Add a quaternary clause to the solver. 
     bool    addClause_(      vec<Lit>& ps);                     // Add a clause to the solver without making superflous internal copy. Will
                                                                 // change the passed vector 'ps'.
+    bool    addClauses(const vec<Lit>& lits, const vec<int>& offsets, int threads = 1);
+                                                                // Add many clauses at once: clause 'i' consists of 'lits[offsets[i]]'
+                                                                // up to 'lits[offsets[i+1]-1]'. Normalization may use several threads.
+    bool    addClauses(const Lit* lits, const int* offsets, int n_clauses, int threads = 1);
+                                                                // Same as above for 'n_clauses' clauses in plain arrays (e.g. memory mapped).
+    bool    addAtMost (const vec<Lit>& ps, int k);              // Add the constraint that at most 'k' of the literals 'ps' are true
+                                                                // (duplicates count once). Its variables must not be released. Not
+                                                                // covered by DRAT proofs or the CNF output ('toDimacs()' etc.).
+    bool    addXor    (const vec<Lit>& ps);                     // Add the constraint that an odd number of the literals 'ps' are true
+                                                                // (their XOR is true). The same restrictions apply.
+    bool    hasNative () const;                                 // TRUE once 'addAtMost()' or 'addXor()' was called: a DRAT proof is
+                                                                // then not valid.
 
     // Solving:
     //
@@ -68,6 +87,21 @@ public:
 
     bool    implies      (const vec<Lit>& assumps, vec<Lit>& out);
 
+    // Core minimization: if 'assumps' are unsatisfiable, shrink them to a subset 'out_core' that is
+    // still unsatisfiable and from which no literal can be dropped (unless a check of at most
+    // 'check_conflicts' conflicts could not decide it). 'jobs > 1' runs that many checks at once in
+    // forked copies of the solver. Returns 'l_True' with a model if the assumptions are satisfiable,
+    // 'l_Undef' if the first call hits the resource constraints.
+    lbool   minimizeCore (const vec<Lit>& assumps, vec<Lit>& out_core, int64_t check_conflicts = 1000, int jobs = 1);
+
+    // Model enumeration (AllSAT): pass every model under 'assumps', projected onto the variables
+    // 'project' (all decision variables if empty), to 'on_model' as literals; no projection is passed
+    // twice. Stops when 'on_model' returns FALSE, after 'max_models' models (0 = no limit) or on the resource
+    // constraints. Returns 'l_False' if all models were enumerated, 'l_True' if stopped early and
+    // 'l_Undef' on the resource constraints. (On a 'SimpSolver', freeze the projected variables.)
+    lbool   enumerate    (const vec<Lit>& assumps, const vec<Var>& project,
+                          const std::function<bool(const vec<Lit>&)>& on_model, uint64_t max_models = 0);
+
     // Iterate over clauses and top-level assignments:
     ClauseIterator clausesBegin() const;
     ClauseIterator clausesEnd()   const;
@@ -77,6 +111,21 @@ public:
     void    toDimacs     (FILE* f, const vec<Lit>& assumps);            // Write CNF to file in DIMACS-format.
     void    toDimacs     (const char *file, const vec<Lit>& assumps);
     void    toDimacs     (FILE* f, Clause& c, vec<Var>& map, Var& max);
+    void    toBinaryCnf  (FILE* f, const vec<Lit>& assumps, bool varint = false); // Write CNF to file in the binary format (see 'BinaryCnf.h').
+    void    toBinaryCnf  (const char* file, const vec<Lit>& assumps, bool varint = false);
+
+    // Proof output: once 'proof' is opened, every derived clause and every deletion is logged in
+    // DRAT format. 'closeProof()' adds the empty clause if the solver is in a contradictory state and
+    // writes out the rest of the proof (FALSE on write errors).
+    bool    closeProof   ();
+
+    // Checkpointing: the search state (clauses, learnt clauses, top-level assignments, variable
+    // activities, polarities and preferences, learnt clause limits) can be saved to a file and
+    // loaded into a fresh solver to resume the search later (see 'Checkpoint.h').
+    bool    saveCheckpoint   (const char* file);  // Write the state (FALSE on errors). The file is replaced atomically.
+    bool    loadCheckpoint   (const char* file);  // Load the state into a solver without variables (FALSE if not a valid checkpoint).
+    bool    checkpoint       ();                  // Save to 'checkpoint_file' from a forked child, without stopping the search.
+    void    requestCheckpoint();                  // Make the search call 'checkpoint()' at its next decision (safe in signal handlers).
 
     // Convenience versions of 'toDimacs()':
     void    toDimacs     (const char* file);
@@ -101,6 +150,7 @@ public:
     int     nVars      ()      const;       // The current number of variables.
     int     nFreeVars  ()      const;
     void    printStats ()      const;       // Print some current statistics to standard output.
+    virtual void collectStats(SolverStats& out) const; // Append all statistics (counters and phase timers) to 'out'.
 
     // Resource contraints:
     //
@@ -142,12 +192,47 @@ public:
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
 
+    bool      use_inprocessing;   // Periodically simplify the clause database during search.
+    int       inprocess_interval; // Number of conflicts before the first inprocessing round.
+    double    inprocess_inc;      // The interval between inprocessing rounds is multiplied with this factor.
+    double    inprocess_effort;   // Budget of a round relative to the propagations since the previous one.
+    bool      use_vivify;         // Shorten the more active learnt clauses during inprocessing.
+    bool      use_probing;        // Failed-literal probing with hyper-binary resolution during preprocessing and inprocessing.
+    int64_t   probe_budget;       // Propagation budget of the probing pass that precedes the search.
+    int       probe_max_hbr;      // Maximal number of hyper-binary resolvents added per probed literal.
+    const char* checkpoint_file;  // Target of 'checkpoint()' (NULL means checkpoints are not taken).
+    bool      reuse_trail;        // Keep the assumption levels after 'solve()' and reuse those shared with the next call's
+                                  // assumptions. Until then, 'value()' reflects these assumptions; any change to the
+                                  // clauses or 'simplify()' drops them first.
+    bool      assumps_one_level;  // Put all assumptions on a single decision level (scales to very many assumptions).
+    bool      enum_proj_first;    // Decide the projected variables first in 'enumerate()' (shorter blocking clauses; fast
+                                  // when there are many models, but it can slow down the search for them).
+    bool      stats_timers;       // Measure the time spent in the phases of the search ('time_propagate' etc.).
+
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
     uint64_t dec_vars, num_clauses, num_learnts, clauses_literals, learnts_literals, max_literals, tot_literals;
 
+    struct InprocessStats {
+        uint64_t runs;           // Number of times the technique was run.
+        uint64_t clauses;        // Number of clauses removed or derived.
+        uint64_t literals;       // Number of literals removed.
+        double   time;           // CPU time spent (seconds).
+        InprocessStats() : runs(0), clauses(0), literals(0), time(0) {}
+    };
+    uint64_t       inprocessings, reused_levels, core_checks;
+    InprocessStats stats_subsume, stats_elim, stats_vivify, stats_probe;
+    uint64_t       watcher_visits, blocker_hits, clause_visits;  // In 'propagate()': watchers looked at, skipped thanks
+                                                                 // to their blocker, and whose clause was read.
+
+    // Phase timers (only counted if 'stats_timers' is set; CPU time for the coarse phases only):
+    PhaseTime      time_propagate, time_analyze, time_reduce, time_simplify, time_gc, time_watcher;
+
     std::unique_ptr<ExternalWatcher> external_watcher; // New member for external watcher
+    DratWriter     proof;             // DRAT proof output (inactive unless opened).
+    TraceWriter    trace;             // Search event trace (inactive unless opened; only recorded when compiled
+                                      // with MINISAT_TRACE, see 'Trace.h').
 
 protected:
 
@@ -190,6 +275,7 @@ protected:
     vec<Lit>            trail;            // Assignment stack; stores all assigments made in the order they were made.
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
     vec<Lit>            assumptions;      // Current set of assumptions provided to solve by the user.
+    vec<Lit>            kept_assumps;     // Assumptions of the decision levels kept from the previous call ('reuse_trail').
 
     VMap<double>        activity;         // A heuristic measurement of the activity of a variable.
     VMap<lbool>         assigns;          // The current assignments.
@@ -209,6 +295,7 @@ protected:
     int                 qhead;            // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
     int                 simpDB_assigns;   // Number of top-level assignments since last execution of 'simplify()'.
     int64_t             simpDB_props;     // Remaining number of propagations that must be made before next execution of 'simplify()'.
+    int                 proof_units;      // Number of top-level assignments already logged as unit clauses in the proof.
     double              progress_estimate;// Set by 'search()'.
     bool                remove_satisfied; // Indicates whether possibly inefficient linear scan for satisfied clauses should be performed in 'simplify'.
     Var                 next_var;         // Next variable to be created.
@@ -218,6 +305,55 @@ protected:
     vec<Var>            free_vars;
     CRef                best_clause;  // Best clause during single start, to be preserved
 
+    struct Enumeration {
+        const std::function<bool(const vec<Lit>&)>* on_model;
+        vec<Var>        project;
+        vec<char>       projected;        // Membership in 'project' (indexed by variable).
+        vec<Lit>        model;            // The projected model passed to 'on_model'.
+        uint64_t        max_models, models;
+        Lit             act;              // The activation literal (the last assumption) guarding the blocking clauses.
+    };
+    Enumeration*        enumeration;      // The enumeration in progress ('enumerate()'), or NULL.
+
+    // At-most constraints: a counter of the true literals per constraint, updated as the trail is
+    // propagated. When it reaches 'k', the other literals are made false with the reason 'CRef_Lazy';
+    // the reason clause is only built if 'analyze()' asks for it ('reasonClause()').
+    struct AtMost {
+        int             lits;             // Index of the literals in 'atmost_lits', followed by 'k+1' slots holding the
+        int             size;             // literals counted so far (in trail order).
+        int             k;
+        int             count;
+    };
+    vec<AtMost>         atmosts;          // List of at-most constraints.
+    vec<Lit>            atmost_lits;
+    vec<vec<int> >      atmost_occs;      // 'atmost_occs[toInt(p)]' lists the constraints containing 'p' (grown on demand).
+    VMap<int>           atmost_reason;    // The constraint that implied a variable (-1 if none).
+    int                 atmost_qhead;     // Head of the trail as seen by the counters ('trail[0..atmost_qhead)' are counted).
+
+    // XOR constraints: a matrix in reduced row echelon form over the columns of the XOR variables. The
+    // basic column of a row is kept unassigned while the row has another unassigned column (Gauss-Jordan
+    // elimination during propagation; it is not undone on backtracking). Each row also watches one other
+    // unassigned column; when there is none, the basic variable is implied. The reason of an implication
+    // is a copy of the row, turned into a clause only if 'analyze()' asks for it.
+    BitMatrix           xor_rows;
+    vec<char>           xor_rhs;          // Right-hand side of each row.
+    vec<int>            xor_basic;        // Basic column of each row.
+    vec<int>            xor_watch;        // Watched column of each row.
+    vec<int>            xor_col;          // Column of each variable (-1 if none, grown on demand).
+    vec<Var>            xor_var;          // Variable of each column.
+    vec<int>            xor_basic_row;    // Row of each basic column (-1 if not basic).
+    vec<vec<int> >      xor_watches;      // Rows watching each column (entries of rows that moved on are dropped lazily).
+    vec<uint64_t>       xor_assigned;     // Columns assigned in 'trail[0..xor_qhead)'.
+    vec<uint64_t>       xor_values;       // Their values.
+    vec<int>            xor_dirty;        // Rows changed by an elimination step, to be checked again.
+    vec<char>           xor_in_dirty;
+    vec<uint64_t>       xor_expl;         // Copies of the rows that implied the current assignments.
+    VMap<int>           xor_reason;       // Offset of the row that implied a variable in 'xor_expl' (-1 if none).
+    int                 xor_qhead;        // Head of the trail as seen by the matrix.
+    bool                native_added;     // Was 'addAtMost()' or 'addXor()' called (even if the constraint was simplified away)?
+    CRef                lazy_confl;       // The conflict clause of the last conflicting at-most or XOR constraint (freed by
+                                          // the next 'propagate()').
+
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
     // used, exept 'seen' wich is used in several places.
     //
@@ -225,6 +361,10 @@ protected:
     vec<ShrinkStackElem>analyze_stack;
     vec<Lit>            analyze_toclear;
     vec<Lit>            add_tmp;
+    vec<Lit>            proof_tmp;        // Original literals of a clause that is being shortened (for the proof).
+    vec<Lit>            lazy_tmp;
+    vec<int>            xor_ws;
+    vec<char>           lbd_seen;
 
     double              max_learnts;
     double              learntsize_adjust_confl;
@@ -232,9 +372,15 @@ protected:
 
     // Resource contraints:
     //
+    uint64_t            next_inprocess;     // Conflict count at which the next inprocessing round is due.
+    double              inprocess_confl;    // Current number of conflicts between inprocessing rounds.
+    uint64_t            inprocess_props;    // Value of 'propagations' at the end of the previous round.
+
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
     bool                asynch_interrupt;
+    bool                checkpoint_requested;
+    pid_t               checkpoint_pid;     // Child process writing the latest checkpoint (0 if none).
 
     // Main internal methods:
     //
@@ -244,15 +390,44 @@ protected:
     void     uncheckedEnqueue (Lit p, CRef from = CRef_Undef);                         // Enqueue a literal. Assumes value of literal is undefined.
     bool     enqueue          (Lit p, CRef from = CRef_Undef);                         // Test if fact 'p' contradicts current state, enqueue otherwise.
     CRef     propagate        ();                                                      // Perform unit propagation. Returns possibly conflicting clause.
+    CRef     propagateAtMost  ();                                                      // Count the rest of the trail in the at-most constraints.
+    void     attachAtMost     (const vec<Lit>& ps, int k);                             // Store a normalized at-most constraint.
+    void     cancelAtMost     (int level);                                             // (helper method for 'cancelUntil()')
+    CRef     propagateXor     ();                                                      // Bring the XOR matrix up to date with the trail.
+    bool     updateXor        (int r);                                                 // Restore the watches of row 'r'. TRUE if it is conflicting.
+    void     pivotXor         (int r, int c);                                          // Make 'c' the basic column of row 'r'.
+    CRef     xorClause        (const uint64_t* row, Lit implied);                      // A row as a clause false but for 'implied' (if given).
+    int      xorUnassigned    (const uint64_t* row, int skip) const;                   // First column of 'row' not assigned in the matrix (or -1).
+    void     cancelXor        (int level);                                             // (helper method for 'cancelUntil()')
+    void     cancelLazy       (int level);                                             // Drop the lazy reasons above 'level'.
+    CRef     reasonClause     (Var x);                                                 // The reason of 'x', built first if it is 'CRef_Lazy'.
+    CRef     lazyReason       (Var x);
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
+    void     cancelKept       ();                                                      // Backtrack the levels kept by 'reuse_trail'.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel);    // (bt = backtrack)
+    int      computeLBD       (const vec<Lit>& c);                                     // Number of distinct decision levels in 'c'.
     void     analyzeFinal     (Lit p, LSet& out_conflict);                             // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
+    void     analyzeFinal     (CRef confl, LSet& out_conflict);                        // (for a conflict on the level of the assumptions)
+    void     analyzeFinalMarked(LSet& out_conflict);                                   // (helper method for 'analyzeFinal()')
     bool     litRedundant     (Lit p);                                                 // (helper method for 'analyze()')
     lbool    search           (int curr_restarts);                                                      // Search until a restart
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
+    void     logUnits         ();                                                      // Log new top-level assignments as units before their reasons may be deleted.
     void     rebuildOrderHeap ();
+    virtual bool inprocess    ();                                                      // Simplify the clause database at level 0 during search.
+    bool     subsumeLearnts   (int64_t ticks);                                         // Remove learnt clauses subsumed by other clauses.
+    bool     vivifyLearnts    (int64_t ticks);                                         // Shorten learnt clauses by propagating their negation.
+    bool     vivifyClause     (CRef cr);
+    bool     probe            (int64_t props);                                         // Failed-literal probing from the roots of the binary implication graph.
+    bool     probeLit         (Lit p, vec<Lit>& implied, vec<Lit>& hbr);
+    void     coreOf           (const vec<Lit>& assumps, vec<Lit>& out_core);           // The assumptions in the final conflict.
+    lbool    blockModel       ();                                                      // Pass the current model to 'enumeration' and block it.
+    void     checkCore        (const vec<Lit>& core, int fixed, int checks, int64_t check_conflicts,
+                               vec<lbool>& results, vec<vec<Lit> >& cores);             // (helper method for 'minimizeCore()')
+    virtual void writeState   (FILE* f);                                               // Write the checkpoint sections (see 'Checkpoint.h').
+    virtual bool readState    (FILE* f);                                               // Read them back into a solver without variables.
 
     // Maintaining Variable/Clause activity:
     //
@@ -303,6 +478,7 @@ protected:
 // Implementation of inline methods:
 
 inline CRef Solver::reason(Var x) const { return vardata[x].reason; }
+inline CRef Solver::reasonClause(Var x) { CRef r = vardata[x].reason; return r != CRef_Lazy ? r : lazyReason(x); }
 inline int  Solver::level (Var x) const { return vardata[x].level; }
 
 inline void Solver::insertVarOrder(Var x) {
@@ -338,10 +514,15 @@ inline bool     Solver::addClause       (Lit p)                 { add_tmp.clear(
 inline bool     Solver::addClause       (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
 inline bool     Solver::addClause       (Lit p, Lit q, Lit r, Lit s){ add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); add_tmp.push(s); return addClause_(add_tmp); }
+inline bool     Solver::addClauses      (const vec<Lit>& lits, const vec<int>& offsets, int threads){
+    return offsets.size() <= 1 ? ok : addClauses(lits.size() > 0 ? &lits[0] : NULL, &offsets[0], offsets.size() - 1, threads); }
 
 inline bool     Solver::isRemoved       (CRef cr)         const { return ca[cr].mark() == 1; }
-inline bool     Solver::locked          (const Clause& c) const { return value(c[0]) == l_True && reason(var(c[0])) != CRef_Undef && ca.lea(reason(var(c[0]))) == &c; }
+inline bool     Solver::locked          (const Clause& c) const {
+    CRef r = reason(var(c[0]));
+    return value(c[0]) == l_True && r != CRef_Undef && r != CRef_Lazy && ca.lea(r) == &c; }
 inline void     Solver::newDecisionLevel()                      { trail_lim.push(trail.size()); }
+inline void     Solver::cancelKept      ()                      { if (kept_assumps.size() > 0){ cancelUntil(0); kept_assumps.clear(); } }
 
 inline int      Solver::decisionLevel ()      const   { return trail_lim.size(); }
 inline uint32_t Solver::abstractLevel (Var x) const   { return 1 << (level(x) & 31); }
@@ -353,6 +534,7 @@ inline int      Solver::nAssigns      ()      const   { return trail.size(); }
 inline int      Solver::nClauses      ()      const   { return num_clauses; }
 inline int      Solver::nLearnts      ()      const   { return num_learnts; }
 inline int      Solver::nVars         ()      const   { return next_var; }
+inline bool     Solver::hasNative     ()      const   { return native_added; }
 // TODO: nFreeVars() is not quite correct, try to calculate right instead of adapting it like below:
 inline int      Solver::nFreeVars     ()      const   { return (int)dec_vars - (trail_lim.size() == 0 ? trail.size() : trail_lim[0]); }
 inline void     Solver::setPolarity   (Var v, lbool b){ user_pol[v] = b; }
@@ -368,6 +550,7 @@ inline void     Solver::setConfBudget(int64_t x){ conflict_budget    = conflicts
 inline void     Solver::setPropBudget(int64_t x){ propagation_budget = propagations + x; }
 inline void     Solver::interrupt(){ asynch_interrupt = true; }
 inline void     Solver::clearInterrupt(){ asynch_interrupt = false; }
+inline void     Solver::requestCheckpoint(){ checkpoint_requested = true; }
 inline void     Solver::budgetOff(){ conflict_budget = propagation_budget = -1; }
 inline bool     Solver::withinBudget() const {
     return !asynch_interrupt &&
@@ -148,15 +148,23 @@ class Clause {
 
     friend class ClauseAllocator;
 
+    // Number of 32-bit words following the literals: the activity of a learnt clause, or the
+    // 64-bit abstraction of a problem clause.
+    static int extraWords(bool has_extra, bool learnt) { return has_extra ? (learnt ? 1 : 2) : 0; }
+    int        extraWords() const { return extraWords(header.has_extra, header.learnt); }
+
     // NOTE: This constructor cannot be used directly (doesn't allocate enough memory).
-    Clause(const vec<Lit>& ps, bool use_extra, bool learnt) {
-        header.mark      = 0;
-        header.learnt    = learnt;
-        header.has_extra = use_extra;
-        header.reloced   = 0;
-        header.size      = ps.size();
-
-        for (int i = 0; i < ps.size(); i++) 
+    // 'ps' is any indexable sequence of 'size' literals (a 'vec<Lit>' or a plain array).
+    template<class Lits>
+    Clause(const Lits& ps, int size, bool use_extra, bool learnt) {
+        header.mark       = 0;
+        header.learnt     = learnt;
+        header.has_extra  = use_extra;
+        header.reloced    = 0;
+        header.persistent = 0;
+        header.size       = size;
+
+        for (int i = 0; i < size; i++) 
             data[i].lit = ps[i];
 
         if (header.has_extra){
@@ -177,23 +185,27 @@ class Clause {
 
         if (header.has_extra){
             if (header.learnt)
-                data[header.size].act = from.data[header.size].act;
-            else 
-                data[header.size].abs = from.data[header.size].abs;
+                data[header.size].act = from.has_extra() ? from.data[header.size].act : 0;
+            else if (from.has_extra()){
+                data[header.size  ].abs = from.data[header.size  ].abs;
+                data[header.size+1].abs = from.data[header.size+1].abs;
+            }else
+                calcAbstraction();
     }
     }
 
 public:
     void calcAbstraction() {
-        assert(header.has_extra);
-        uint32_t abstraction = 0;
+        assert(header.has_extra && !header.learnt);
+        uint64_t abstraction = 0;
         for (int i = 0; i < size(); i++)
-            abstraction |= 1 << (var(data[i].lit) & 31);
-        data[header.size].abs = abstraction;  }
+            abstraction |= (uint64_t)1 << (var(data[i].lit) & 63);
+        data[header.size  ].abs = (uint32_t)abstraction;
+        data[header.size+1].abs = (uint32_t)(abstraction >> 32); }
 
 
     int          size        ()      const   { return header.size; }
-    void         shrink      (int i)         { assert(i <= size()); if (header.has_extra) data[header.size-i] = data[header.size]; header.size -= i; }
+    void         shrink      (int i)         { assert(i <= size()); for (int k = 0; k < extraWords(); k++) data[header.size-i+k] = data[header.size+k]; header.size -= i; }
     void         pop         ()              { shrink(1); }
     bool         learnt      ()      const   { return header.learnt; }
     bool         has_extra   ()      const   { return header.has_extra; }
@@ -216,7 +228,8 @@ public:
     operator const Lit* (void) const         { return (Lit*)data; }
 
     float&       activity    ()              { assert(header.has_extra); return data[header.size].act; }
-    uint32_t     abstraction () const        { assert(header.has_extra); return data[header.size].abs; }
+    uint64_t     abstraction () const        { assert(header.has_extra && !header.learnt);
+                                               return data[header.size].abs | ((uint64_t)data[header.size+1].abs << 32); }
 
     Lit          subsumes    (const Clause& other) const;
     void         strengthen  (Lit p);
@@ -227,12 +240,13 @@ public:
 // ClauseAllocator -- a simple class for allocating memory for clauses:
 
 const CRef CRef_Undef = RegionAllocator<uint32_t>::Ref_Undef;
+const CRef CRef_Lazy  = RegionAllocator<uint32_t>::Ref_Undef - 1; // Reason of an implication by an at-most or XOR constraint (not yet a clause).
 class ClauseAllocator
 {
     RegionAllocator<uint32_t> ra;
 
-    static uint32_t clauseWord32Size(int size, bool has_extra){
-        return (sizeof(Clause) + (sizeof(Lit) * (size + (int)has_extra))) / sizeof(uint32_t); }
+    static uint32_t clauseWord32Size(int size, int extra_words){
+        return (sizeof(Clause) + (sizeof(Lit) * (size + extra_words))) / sizeof(uint32_t); }
 
  public:
     enum { Unit_Size = RegionAllocator<uint32_t>::Unit_Size };
@@ -251,16 +265,32 @@ class ClauseAllocator
         assert(sizeof(Lit)      == sizeof(uint32_t));
         assert(sizeof(float)    == sizeof(uint32_t));
         bool use_extra = learnt | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(ps.size(), use_extra));
-        new (lea(cid)) Clause(ps, use_extra, learnt);
+        CRef cid       = ra.alloc(clauseWord32Size(ps.size(), Clause::extraWords(use_extra, learnt)));
+        new (lea(cid)) Clause(ps, ps.size(), use_extra, learnt);
+
+        return cid;
+    }
 
+    CRef alloc(const Lit* ps, int size, bool learnt = false)
+    {
+        bool use_extra = learnt | extra_clause_field;
+        CRef cid       = ra.alloc(clauseWord32Size(size, Clause::extraWords(use_extra, learnt)));
+        new (lea(cid)) Clause(ps, size, use_extra, learnt);
         return cid;
     }
 
+    // Make room for 'clauses' more problem clauses with 'lits' literals in total:
+    void reserve(uint64_t clauses, uint64_t lits)
+    {
+        uint64_t words = clauses * clauseWord32Size(0, Clause::extraWords(extra_clause_field, false)) + lits;
+        if (words > 0 && words <= UINT32_MAX - ra.size())
+            ra.reserve((uint32_t)words);
+    }
+
     CRef alloc(const Clause& from)
     {
         bool use_extra = from.learnt() | extra_clause_field;
-        CRef cid       = ra.alloc(clauseWord32Size(from.size(), use_extra));
+        CRef cid       = ra.alloc(clauseWord32Size(from.size(), Clause::extraWords(use_extra, from.learnt())));
         new (lea(cid)) Clause(from, use_extra);
         return cid; }
 
@@ -277,7 +307,7 @@ class ClauseAllocator
     void free(CRef cid)
     {
         Clause& c = operator[](cid);
-        ra.free(clauseWord32Size(c.size(), c.has_extra()));
+        ra.free(clauseWord32Size(c.size(), c.extraWords()));
     }
 
     void reloc(CRef& cr, ClauseAllocator& to)
@@ -445,7 +475,7 @@ inline Lit Clause::subsumes(const Clause& other) const
     //if (other.size() < size() || (!learnt() && !other.learnt() && (extra.abst & ~other.extra.abst) != 0))
     assert(!header.learnt);   assert(!other.header.learnt);
     assert(header.has_extra); assert(other.header.has_extra);
-    if (other.header.size < header.size || (data[header.size].abs & ~other.data[other.header.size].abs) != 0)
+    if (other.header.size < header.size || (abstraction() & ~other.abstraction()) != 0)
         return lit_Error;
 
     Lit        ret = lit_Undef;
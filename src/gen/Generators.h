@@ -0,0 +1,182 @@
+#ifndef Minisat_Generators_h
+#define Minisat_Generators_h
+
+#include "src/mtl/Rnd.h"
+#include "src/core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Generators of synthetic instances:
+//
+// Each generator adds new variables (after the ones already in 'S') and the constraints of its
+// family to 'S', which may be a 'Solver', a 'SimpSolver' or anything else with 'newVar()',
+// 'addClause()' and, for native parity constraints, 'addXor()'. The same parameters and seed
+// always give the same instance. To get a DIMACS file, generate into a 'Solver' and call
+// 'toDimacs()' (see 'minisat_gen').
+
+
+// A random generator state ('drand()' etc.) from a seed; different seeds give different states:
+static inline double gen_seed(uint32_t seed) { return (double)(((uint64_t)seed * 2654435761u) % 2147483646 + 1); }
+
+
+// Tseitin encodings of 'out <-> (a & b)' and 'out <-> (a ^ b)':
+template<class Solver>
+static void gen_and(Solver& S, Lit out, Lit a, Lit b) {
+    S.addClause(~out, a);
+    S.addClause(~out, b);
+    S.addClause(out, ~a, ~b); }
+
+template<class Solver>
+static void gen_xor(Solver& S, Lit out, Lit a, Lit b) {
+    S.addClause(~out, a, b);
+    S.addClause(~out, ~a, ~b);
+    S.addClause(out, ~a, b);
+    S.addClause(out, a, ~b); }
+
+
+// Uniform random k-SAT: 'ratio * vars' clauses of 'k' different variables with random signs. The
+// threshold between mostly satisfiable and mostly unsatisfiable instances is a ratio of about 4.26
+// for 3-SAT; near it the instances are hardest (conflict analysis), far below it the search is
+// mostly propagation.
+template<class Solver>
+static void gen_randomKSat(Solver& S, int vars, int k, double ratio, uint32_t seed)
+{
+    double   rnd     = gen_seed(seed);
+    Var      first   = S.nVars();
+    int      clauses = (int)(ratio * vars + 0.5);
+    vec<Lit> lits;
+    for (int i = 0; i < vars; i++) S.newVar();
+    for (int i = 0; i < clauses; i++){
+        lits.clear();
+        while (lits.size() < k){
+            Var v   = first + irand(rnd, vars);
+            bool dup = false;
+            for (int j = 0; j < lits.size(); j++)
+                dup |= var(lits[j]) == v;
+            if (!dup) lits.push(mkLit(v, drand(rnd) < 0.5)); }
+        S.addClause(lits);
+    }
+}
+
+
+// The pigeonhole principle: 'holes' + 1 pigeons, each in some hole, no two in the same one.
+// Unsatisfiable and exponential for resolution: every conflict needs analysis.
+template<class Solver>
+static void gen_pigeonhole(Solver& S, int holes)
+{
+    int      pigeons = holes + 1;
+    Var      first   = S.nVars();
+    vec<Lit> lits;
+    for (int i = 0; i < pigeons * holes; i++) S.newVar();
+#define in_hole(p, h) mkLit(first + (p) * holes + (h))
+    for (int p = 0; p < pigeons; p++){
+        lits.clear();
+        for (int h = 0; h < holes; h++) lits.push(in_hole(p, h));
+        S.addClause(lits); }
+    for (int h = 0; h < holes; h++)
+        for (int p = 0; p < pigeons; p++)
+            for (int q = p + 1; q < pigeons; q++)
+                S.addClause(~in_hole(p, h), ~in_hole(q, h));
+#undef in_hole
+}
+
+
+// Two parity constraints over the same 'vars' variables, in different random orders, claiming
+// odd and even parity. Unsatisfiable. As chains of Tseitin XOR gates, the instance is hard for
+// CDCL already around 50 variables; with 'native_xor', the two constraints are given to 'addXor()'
+// and Gauss-Jordan elimination refutes them at once.
+template<class Solver>
+static void gen_parity(Solver& S, int vars, uint32_t seed, bool native_xor)
+{
+    double   rnd   = gen_seed(seed);
+    Var      first = S.nVars();
+    vec<Lit> xs;
+    for (int i = 0; i < vars; i++){
+        S.newVar();
+        xs.push(mkLit(first + i)); }
+
+    for (int odd = 1; odd >= 0; odd--){
+        randomShuffle(rnd, xs);
+        if (native_xor){
+            vec<Lit> lits; xs.copyTo(lits);
+            if (!odd) lits[0] = ~lits[0];
+            S.addXor(lits);
+            continue; }
+
+        // 'sum' is the parity of the prefix so far:
+        Lit sum = xs[0];
+        for (int i = 1; i < vars; i++){
+            Lit next = mkLit(S.newVar());
+            gen_xor(S, next, sum, xs[i]);
+            sum = next; }
+        S.addClause(odd ? sum : ~sum);
+    }
+}
+
+
+// Coloring of a random graph with 'vertices' vertices and 'density * vertices' edges (without
+// loops; an edge may repeat) with 'colors' colors: each vertex gets exactly one color, and the
+// ends of an edge get different ones. For 3 colors, the threshold is at a density of about 2.3.
+template<class Solver>
+static void gen_coloring(Solver& S, int vertices, double density, int colors, uint32_t seed)
+{
+    double   rnd   = gen_seed(seed);
+    Var      first = S.nVars();
+    int      edges = (int)(density * vertices + 0.5);
+    vec<Lit> lits;
+    for (int i = 0; i < vertices * colors; i++) S.newVar();
+#define colored(v, c) mkLit(first + (v) * colors + (c))
+    for (int v = 0; v < vertices; v++){
+        lits.clear();
+        for (int c = 0; c < colors; c++) lits.push(colored(v, c));
+        S.addClause(lits);
+        for (int c = 0; c < colors; c++)
+            for (int d = c + 1; d < colors; d++)
+                S.addClause(~colored(v, c), ~colored(v, d)); }
+    for (int i = 0; i < edges; i++){
+        int v = irand(rnd, vertices), w = irand(rnd, vertices);
+        if (v == w){ i--; continue; }
+        for (int c = 0; c < colors; c++)
+            S.addClause(~colored(v, c), ~colored(w, c)); }
+#undef colored
+}
+
+
+// A bounded model checking unrolling: a 'bits'-wide counter starts at 0 and is incremented in each
+// of 'steps' steps if the input of the step is set (a ripple-carry adder of Tseitin gates). The
+// property "the counter never has all bits set" is violated, i.e. the instance satisfiable, iff
+// 'steps' >= 2^'bits' - 1. The gate structure gives variable elimination a lot to do, and long
+// implication chains a lot to propagate.
+template<class Solver>
+static void gen_counter(Solver& S, int bits, int steps)
+{
+    vec<Lit> state, next;
+    for (int i = 0; i < bits; i++){
+        state.push(mkLit(S.newVar()));
+        S.addClause(~state.last()); }
+
+    for (int t = 0; t < steps; t++){
+        Lit carry = mkLit(S.newVar());   // (the input of the step)
+        next.clear();
+        for (int i = 0; i < bits; i++){
+            next.push(mkLit(S.newVar()));
+            gen_xor(S, next[i], state[i], carry);
+            if (i + 1 < bits){
+                Lit c = mkLit(S.newVar());
+                gen_and(S, c, state[i], carry);
+                carry = c; }
+        }
+        next.copyTo(state);
+    }
+
+    // The violation of the property:
+    for (int i = 0; i < bits; i++)
+        S.addClause(state[i]);
+}
+
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,59 @@
+#include <errno.h>
+#include <string.h>
+
+#include "src/utils/Options.h"
+#include "src/core/Solver.h"
+#include "src/gen/Generators.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <family> [output-file]\n\n"
+                  "  Writes a generated instance in DIMACS format (to standard output without a file). Families:\n"
+                  "    random    random k-SAT:      -vars, -k, -ratio, -seed\n"
+                  "    php       pigeonhole:        -n (holes)\n"
+                  "    parity    two parity chains: -vars, -seed\n"
+                  "    coloring  graph coloring:    -vars (vertices), -k (colors), -ratio (edges per vertex), -seed\n"
+                  "    counter   BMC unrolling:     -n (bits), -steps\n");
+
+    IntOption    vars ("MAIN", "vars",  "Variables (random, parity) or vertices (coloring).", 100, IntRange(1, INT32_MAX));
+    IntOption    n    ("MAIN", "n",     "Holes (php) or bits of the counter (counter).", 8, IntRange(1, 30));
+    IntOption    k    ("MAIN", "k",     "Literals per clause (random) or colors (coloring).", 3, IntRange(1, INT32_MAX));
+    DoubleOption ratio("MAIN", "ratio", "Clauses per variable (random) or edges per vertex (coloring).", 4.26, DoubleRange(0, true, HUGE_VAL, false));
+    IntOption    steps("MAIN", "steps", "Steps of the unrolling (counter).", 255, IntRange(0, INT32_MAX));
+    IntOption    seed ("MAIN", "seed",  "Seed of the random choices.", 1, IntRange(0, INT32_MAX));
+
+    parseOptions(argc, argv, true);
+    if (argc != 2 && argc != 3)
+        printUsageAndExit(argc, argv);
+
+    Solver      S;
+    const char* family = argv[1];
+    S.verbosity = 0;
+    if      (strcmp(family, "random") == 0){
+        if (k > vars) fprintf(stderr, "ERROR! More literals per clause than variables\n"), exit(1);
+        gen_randomKSat(S, vars, k, ratio, seed); }
+    else if (strcmp(family, "php") == 0)      gen_pigeonhole(S, n);
+    else if (strcmp(family, "parity") == 0)   gen_parity(S, vars, seed, false);
+    else if (strcmp(family, "coloring") == 0){
+        if (vars < 2) fprintf(stderr, "ERROR! Coloring needs at least 2 vertices\n"), exit(1);
+        gen_coloring(S, vars, ratio, k, seed); }
+    else if (strcmp(family, "counter") == 0)  gen_counter(S, n, steps);
+    else
+        fprintf(stderr, "ERROR! Unknown family: %s\n", family), exit(1);
+
+    // ('toDimacs()' leaves out what is already decided by unit clauses)
+    vec<Lit> assumps;
+    FILE*    out = argc == 3 ? fopen(argv[2], "w") : stdout;
+    if (out == NULL)
+        fprintf(stderr, "ERROR! Could not open file: %s (%s)\n", argv[2], strerror(errno)), exit(1);
+    S.toDimacs(out, assumps);
+    if (fclose(out) != 0)
+        fprintf(stderr, "ERROR! Could not write file: %s\n", argc == 3 ? argv[2] : "<stdout>"), exit(1);
+    return 0;
+}
@@ -57,6 +57,7 @@ class RegionAllocator
     uint32_t wasted    () const      { return wasted_; }
 
     Ref      alloc     (int size); 
+    void     reserve   (uint32_t extra) { capacity(sz + extra); } // Make room for 'extra' more units without reallocating.
     void     free      (int size)    { wasted_ += size; }
 
     // Deref, Load Effective Address (LEA), Inverse of LEA (AEL):
@@ -0,0 +1,95 @@
+#ifndef Minisat_BitMatrix_h
+#define Minisat_BitMatrix_h
+
+#include <string.h>
+
+#include "src/mtl/IntTypes.h"
+#include "src/mtl/Vec.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace Minisat {
+
+//=================================================================================================
+// Bit-packed matrices over GF(2):
+//
+// Rows are stored contiguously as 64-bit words ('stride()' words per row); row operations work on
+// whole words (two at a time with SSE2 where available).
+
+
+static inline int  bitWord  (int c)                  { return c >> 6; }
+static inline uint64_t bitMask(int c)                { return (uint64_t)1 << (c & 63); }
+static inline bool bitGet   (const uint64_t* w, int c){ return (w[bitWord(c)] & bitMask(c)) != 0; }
+static inline void bitFlip  (uint64_t* w, int c)     { w[bitWord(c)] ^= bitMask(c); }
+static inline int  bitFirst (uint64_t x)             { return __builtin_ctzll(x); }
+static inline int  bitParity(uint64_t x)             { return __builtin_parityll(x); }
+static inline int  bitCount (uint64_t x)             { return __builtin_popcountll(x); }
+
+
+class BitMatrix {
+    vec<uint64_t> bits;
+    int           words;
+    int           n_rows;
+
+    // Don't allow copying (error prone):
+    BitMatrix& operator=(const BitMatrix&);
+    BitMatrix           (const BitMatrix&);
+
+public:
+    BitMatrix() : words(0), n_rows(0) {}
+
+    int             rows    ()      const { return n_rows; }
+    int             stride  ()      const { return words; }
+    uint64_t*       operator[](int r)       { return &bits[r * words]; }
+    const uint64_t* operator[](int r) const { return &bits[r * words]; }
+
+    // Make room for at least 'cols' columns (moves the rows if the stride grows):
+    void growCols(int cols) {
+        int w = (cols + 63) >> 6;
+        if (w <= words) return;
+        w = w < 2*words ? 2*words : w;
+        vec<uint64_t> grown(n_rows * w, 0);
+        for (int r = 0; r < n_rows; r++)
+            for (int i = 0; i < words; i++)
+                grown[r * w + i] = bits[r * words + i];
+        grown.moveTo(bits);
+        words = w; }
+
+    // Append a zero row and return its index:
+    int  addRow   () { bits.growTo((n_rows + 1) * words, 0); return n_rows++; }
+    void removeRow() { n_rows--; bits.shrink(words); }   // (the last one)
+
+    // Row 'dst' += row 'src':
+    void xorRow(int dst, int src) {
+        uint64_t*       d = (*this)[dst];
+        const uint64_t* s = (*this)[src];
+        int i = 0;
+#if defined(__SSE2__)
+        for (; i + 2 <= words; i += 2){
+            __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(d + i)), _mm_loadu_si128((const __m128i*)(s + i)));
+            _mm_storeu_si128((__m128i*)(d + i), x); }
+#endif
+        for (; i < words; i++)
+            d[i] ^= s[i]; }
+
+    bool isZero(int r) const {
+        const uint64_t* w = (*this)[r];
+        for (int i = 0; i < words; i++)
+            if (w[i] != 0) return false;
+        return true; }
+
+    // The first non-zero column of row 'r' (-1 if the row is zero):
+    int firstCol(int r) const {
+        const uint64_t* w = (*this)[r];
+        for (int i = 0; i < words; i++)
+            if (w[i] != 0) return i*64 + bitFirst(w[i]);
+        return -1; }
+};
+
+
+//=================================================================================================
+}
+
+#endif
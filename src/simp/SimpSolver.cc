@@ -18,10 +18,15 @@ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE,
 OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 **************************************************************************************************/
 
+#include <atomic>
+#include <thread>
+#include <vector>
+
 #include "src/mtl/Sort.h"
 #include "src/utils/System.h"
 #include "src/utils/Options.h" // Include Options.h
 #include "src/core/Solver.h"
+#include "src/core/Checkpoint.h"
 #include "src/simp/SimpSolver.h"
 
 using namespace Minisat;
@@ -35,9 +40,12 @@ static const char* _cat = "SIMP";
 static BoolOption   opt_use_asymm        (_cat, "asymm",        "Shrink clauses by asymmetric branching.", false);
 static BoolOption   opt_use_rcheck       (_cat, "rcheck",       "Check if a clause is already implied. (costly)", false);
 static BoolOption   opt_use_elim         (_cat, "elim",         "Perform variable elimination.", true);
+static BoolOption   opt_use_equiv        (_cat, "equiv",        "Substitute equivalent literals (SCCs of the binary implication graph).", true);
+static BoolOption   opt_use_gates        (_cat, "gates",        "Restrict resolvents of gate-defined variables (AND/XOR/ITE) to gate/non-gate pairs.", true);
 static IntOption    opt_grow             (_cat, "grow",         "Allow a variable elimination step to grow by a number of clauses.", 0);
 static IntOption    opt_clause_lim       (_cat, "cl-lim",       "Variables are not eliminated if it produces a resolvent with a length above this limit. -1 means no limit", 20,   IntRange(-1, INT32_MAX));
 static IntOption    opt_subsumption_lim  (_cat, "sub-lim",      "Do not check if subsumption against a clause larger than this. -1 means no limit.", 1000, IntRange(-1, INT32_MAX));
+static IntOption    opt_elim_threads     (_cat, "elim-threads", "Number of threads used to compute resolvents in variable elimination (1 = sequential).", 1, IntRange(1, 256));
 static DoubleOption opt_simp_garbage_frac(_cat, "simp-gc-frac", "The fraction of wasted memory allowed before a garbage collection is triggered during simplification.",  0.5, DoubleRange(0, false, HUGE_VAL, false));
 
 
@@ -50,13 +58,18 @@ SimpSolver::SimpSolver() :
   , clause_lim         (opt_clause_lim)
   , subsumption_lim    (opt_subsumption_lim)
   , simp_garbage_frac  (opt_simp_garbage_frac)
+  , elim_threads       (opt_elim_threads)
   , use_asymm          (opt_use_asymm)
   , use_rcheck         (opt_use_rcheck)
   , use_elim           (opt_use_elim)
+  , use_equiv          (opt_use_equiv)
+  , use_gates          (opt_use_gates)
   , extend_model       (true)
   , merges             (0)
   , asymm_lits         (0)
   , eliminated_vars    (0)
+  , substituted_vars   (0)
+  , gates              (0)
   , elimorder          (1)
   , use_simplification (true)
   , occurs             (ClauseDeleted(ca))
@@ -149,6 +162,7 @@ lbool SimpSolver::solve_(bool do_simp, bool turn_off_simp)
 
 bool SimpSolver::addClause_(vec<Lit>& ps)
 {
+    cancelKept();
 #ifndef NDEBUG
     for (int i = 0; i < ps.size(); i++)
         assert(!isEliminated(var(ps[i])));
@@ -162,31 +176,90 @@ bool SimpSolver::addClause_(vec<Lit>& ps)
     if (!Solver::addClause_(ps))
         return false;
 
-    if (use_simplification && clauses.size() == nclauses + 1){
-        CRef          cr = clauses.last();
-        const Clause& c  = ca[cr];
+    if (use_simplification && clauses.size() == nclauses + 1)
+        addOccurrences(clauses.last());
 
-        // NOTE: the clause is added to the queue immediately and then
-        // again during 'gatherTouchedClauses()'. If nothing happens
-        // in between, it will only be checked once. Otherwise, it may
-        // be checked twice unnecessarily. This is an unfortunate
-        // consequence of how backward subsumption is used to mimic
-        // forward subsumption.
-        subsumption_queue.insert(cr);
-        for (int i = 0; i < c.size(); i++){
-            occurs[var(c[i])].push(cr);
-            n_occ[c[i]]++;
-            touched[var(c[i])] = 1;
-            n_touched++;
-            if (elim_heap.inHeap(var(c[i])))
-                elim_heap.increase(var(c[i]));
+    return true;
+}
+
+
+// Variable elimination only preserves the clauses, so the variables of other constraints are frozen:
+bool SimpSolver::addAtMost(const vec<Lit>& ps, int k)
+{
+    for (int i = 0; i < ps.size(); i++){
+        assert(!isEliminated(var(ps[i])));
+        setFrozen(var(ps[i]), true); }
+
+    return Solver::addAtMost(ps, k);
+}
+
+
+bool SimpSolver::addXor(const vec<Lit>& ps)
+{
+    for (int i = 0; i < ps.size(); i++){
+        assert(!isEliminated(var(ps[i])));
+        setFrozen(var(ps[i]), true); }
+
+    return Solver::addXor(ps);
+}
+
+
+bool SimpSolver::addClauses(const Lit* lits, const int* offsets, int n_clauses, int threads)
+{
+#ifndef NDEBUG
+    for (int i = offsets[0]; i < offsets[n_clauses]; i++)
+        assert(!isEliminated(var(lits[i])));
+#endif
+
+    cancelKept();
+    if (use_rcheck){
+        // The implication check depends on the clauses added before, so add one by one:
+        vec<Lit> ps;
+        for (int i = 0; i < n_clauses; i++){
+            ps.clear();
+            for (int j = offsets[i]; j < offsets[i+1]; j++)
+                ps.push(lits[j]);
+            if (!addClause_(ps))
+                return false;
         }
+        return true;
     }
 
+    int nclauses = clauses.size();
+    if (!Solver::addClauses(lits, offsets, n_clauses, threads))
+        return false;
+
+    if (use_simplification)
+        for (int i = nclauses; i < clauses.size(); i++)
+            addOccurrences(clauses[i]);
+
     return true;
 }
 
 
+// Register a new problem clause in the occurrence lists and queue it for subsumption.
+void SimpSolver::addOccurrences(CRef cr)
+{
+    const Clause& c = ca[cr];
+
+    // NOTE: the clause is added to the queue immediately and then
+    // again during 'gatherTouchedClauses()'. If nothing happens
+    // in between, it will only be checked once. Otherwise, it may
+    // be checked twice unnecessarily. This is an unfortunate
+    // consequence of how backward subsumption is used to mimic
+    // forward subsumption.
+    subsumption_queue.insert(cr);
+    for (int i = 0; i < c.size(); i++){
+        occurs[var(c[i])].push(cr);
+        n_occ[c[i]]++;
+        touched[var(c[i])] = 1;
+        n_touched++;
+        if (elim_heap.inHeap(var(c[i])))
+            elim_heap.increase(var(c[i]));
+    }
+}
+
+
 void SimpSolver::removeClause(CRef cr)
 {
     const Clause& c = ca[cr];
@@ -212,10 +285,13 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
     // if (!find(subsumption_queue, &c))
     subsumption_queue.insert(cr);
 
+    proof.add(c, l);
     if (c.size() == 2){
         removeClause(cr);
         c.strengthen(l);
     }else{
+        logUnits();
+        proof.remove(c);
         detachClause(cr, true);
         c.strengthen(l);
         attachClause(cr);
@@ -229,9 +305,8 @@ bool SimpSolver::strengthenClause(CRef cr, Lit l)
 
 
 // Returns FALSE if clause is always satisfied ('out_clause' should not be used).
-bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause)
+static bool mergeClauses(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause)
 {
-    merges++;
     out_clause.clear();
 
     bool  ps_smallest = _ps.size() < _qs.size();
@@ -261,10 +336,8 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& ou
 
 
 // Returns FALSE if clause is always satisfied.
-bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
+static bool mergeClauses(const Clause& _ps, const Clause& _qs, Var v, int& size)
 {
-    merges++;
-
     bool  ps_smallest = _ps.size() < _qs.size();
     const Clause& ps  =  ps_smallest ? _qs : _ps;
     const Clause& qs  =  ps_smallest ? _ps : _qs;
@@ -291,6 +364,218 @@ bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
 }
 
 
+//=================================================================================================
+// Gate detection:
+//
+// If 'v' is the output of a gate, i.e. some of its clauses ('G') define it as a function of other
+// variables, only the resolvents between gate and non-gate clauses are needed when eliminating
+// 'v'. Resolvents among the gate clauses are tautologies semantically, and resolvents among the
+// non-gate clauses are implied by the remaining ones. The clauses stored for model extension are
+// unchanged. The functions below mark the gate clauses in 'pos_gate'/'neg_gate'.
+
+
+// The literal of 'v' in 'c'.
+static inline Lit litOf(const Clause& c, Var v)
+{
+    for (int i = 0; i < c.size(); i++)
+        if (var(c[i]) == v)
+            return c[i];
+    return lit_Undef;
+}
+
+
+// The literal of 'c' that is not over 'v', for binary clauses.
+static inline Lit otherLit(const Clause& c, Var v)
+{
+    assert(c.size() == 2);
+    return var(c[0]) == v ? c[1] : c[0];
+}
+
+
+// Does the ternary clause 'c' contain the literals 'p' and 'q' (besides its literal of 'v')?
+static inline bool ternaryHas(const Clause& c, Lit p, Lit q)
+{
+    assert(c.size() == 3);
+    return (c[0] == p || c[1] == p || c[2] == p) && (c[0] == q || c[1] == q || c[2] == q);
+}
+
+
+// y = AND(l1, .., lk), where 'y' is the literal of 'v' in the binary clauses '(~y | li)' of 'bins'
+// and the long clause '(y | ~l1 | .. | ~lk)' is in 'longs'.
+static bool findAndGate(const ClauseAllocator& ca, Var v, const vec<CRef>& longs, const vec<CRef>& bins, vec<char>& long_gate, vec<char>& bin_gate)
+{
+    // Binary clauses, sorted by their other literal (literal index in the high bits):
+    vec<uint64_t> bin_lits;
+    for (int i = 0; i < bins.size(); i++)
+        if (ca[bins[i]].size() == 2)
+            bin_lits.push(((uint64_t)toInt(otherLit(ca[bins[i]], v)) << 32) | (uint32_t)i);
+    if (bin_lits.size() == 0)
+        return false;
+    sort(bin_lits);
+
+    for (int i = 0; i < longs.size(); i++){
+        const Clause& c = ca[longs[i]];
+        if (c.size() - 1 > bin_lits.size()) continue;
+
+        int k;
+        for (k = 0; k < c.size(); k++){
+            if (var(c[k]) == v) continue;
+            uint64_t key = (uint64_t)toInt(~c[k]) << 32;
+            int lo = 0, hi = bin_lits.size();
+            while (lo < hi){
+                int mid = (lo + hi) / 2;
+                if (bin_lits[mid] < key) lo = mid + 1; else hi = mid; }
+            if (lo == bin_lits.size() || (bin_lits[lo] >> 32) != (key >> 32))
+                break;
+        }
+        if (k < c.size()) continue;
+
+        // Found: mark the long clause and one binary clause per literal.
+        long_gate[i] = 1;
+        for (k = 0; k < c.size(); k++){
+            if (var(c[k]) == v) continue;
+            for (int j = 0; j < bin_lits.size(); j++)
+                if ((int)(bin_lits[j] >> 32) == toInt(~c[k])){
+                    bin_gate[(uint32_t)bin_lits[j]] = 1;
+                    break; }
+        }
+        return true;
+    }
+    return false;
+}
+
+
+// v = XOR(l1, .., lk) (or its negation) for k < 'max_xor_size': all 2^k clauses over the same
+// variables that have the same parity of negative literals.
+static const int max_xor_size = 5;
+static bool findXorGate(const ClauseAllocator& ca, const vec<CRef>& pos, const vec<CRef>& neg, vec<char>& pos_gate, vec<char>& neg_gate)
+{
+    vec<Var> vars;
+    for (int i = 0; i < pos.size() && i < 16; i++){
+        const Clause& c = ca[pos[i]];
+        if (c.size() < 3 || c.size() > max_xor_size) continue;
+
+        vars.clear();
+        int parity = 0;
+        for (int k = 0; k < c.size(); k++){
+            vars.push(var(c[k]));
+            parity ^= sign(c[k]); }
+        sort(vars);
+
+        // Collect the sign patterns of the matching clauses on both sides:
+        uint32_t found = 0;
+        for (int side = 0; side < 2; side++){
+            const vec<CRef>& cs = side == 0 ? pos : neg;
+            for (int j = 0; j < cs.size(); j++){
+                const Clause& d = ca[cs[j]];
+                if (d.size() != c.size()) continue;
+                uint32_t pattern = 0;
+                int      d_par   = 0, k;
+                for (k = 0; k < d.size(); k++){
+                    int idx = 0;
+                    while (idx < vars.size() && vars[idx] != var(d[k])) idx++;
+                    if (idx == vars.size()) break;
+                    pattern |= (uint32_t)sign(d[k]) << idx;
+                    d_par   ^= sign(d[k]);
+                }
+                if (k == d.size() && d_par == parity)
+                    found |= 1u << pattern;
+            }
+        }
+
+        int n_found = 0;
+        for (uint32_t f = found; f != 0; f &= f - 1) n_found++;
+        if (n_found != 1 << (c.size() - 1)) continue;
+
+        // Found: mark all matching clauses.
+        for (int side = 0; side < 2; side++){
+            const vec<CRef>& cs   = side == 0 ? pos : neg;
+            vec<char>&       mark = side == 0 ? pos_gate : neg_gate;
+            for (int j = 0; j < cs.size(); j++){
+                const Clause& d = ca[cs[j]];
+                if (d.size() != c.size()) continue;
+                int d_par = 0, k;
+                for (k = 0; k < d.size() && find(vars, var(d[k])); k++)
+                    d_par ^= sign(d[k]);
+                if (k == d.size() && d_par == parity)
+                    mark[j] = 1;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+
+// x = ITE(c, t, e): '(~x | ~c | t)', '(~x | c | e)' in 'neg' and '(x | ~c | ~t)', '(x | c | ~e)'
+// in 'pos' (where 'x' is the positive literal of 'v'). Limited to small occurrence lists.
+static bool findIteGate(const ClauseAllocator& ca, Var v, const vec<CRef>& pos, const vec<CRef>& neg, vec<char>& pos_gate, vec<char>& neg_gate)
+{
+    if (pos.size() > 32 || neg.size() > 32)
+        return false;
+
+    for (int i = 0; i < neg.size(); i++){
+        const Clause& a = ca[neg[i]];
+        if (a.size() != 3) continue;
+        for (int j = 0; j < neg.size(); j++){
+            const Clause& b = ca[neg[j]];
+            if (i == j || b.size() != 3) continue;
+            for (int k = 0; k < 3; k++){
+                // Take 'u = ~c' from 'a'; 'b' must contain '~u = c':
+                Lit u = a[k];
+                if (var(u) == v || !find(b, ~u)) continue;
+                Lit t = lit_Undef, e = lit_Undef;
+                for (int l = 0; l < 3; l++){
+                    if (var(a[l]) != v && a[l] != u)  t = a[l];
+                    if (var(b[l]) != v && b[l] != ~u) e = b[l];
+                }
+                if (t == lit_Undef || e == lit_Undef) continue;
+
+                int p1 = -1, p2 = -1;
+                for (int l = 0; l < pos.size(); l++){
+                    const Clause& d = ca[pos[l]];
+                    if (d.size() != 3) continue;
+                    if      (p1 == -1 && ternaryHas(d,  u, ~t)) p1 = l;
+                    else if (p2 == -1 && ternaryHas(d, ~u, ~e)) p2 = l;
+                }
+                if (p1 != -1 && p2 != -1){
+                    neg_gate[i] = neg_gate[j] = 1;
+                    pos_gate[p1] = pos_gate[p2] = 1;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+
+// Find a gate defining 'v'. Returns FALSE if there is none.
+static bool findGate(const ClauseAllocator& ca, Var v, const vec<CRef>& pos, const vec<CRef>& neg, vec<char>& pos_gate, vec<char>& neg_gate)
+{
+    pos_gate.clear(); pos_gate.growTo(pos.size(), 0);
+    neg_gate.clear(); neg_gate.growTo(neg.size(), 0);
+    return findAndGate(ca, v, pos, neg, pos_gate, neg_gate)
+        || findAndGate(ca, v, neg, pos, neg_gate, pos_gate)
+        || findXorGate(ca, pos, neg, pos_gate, neg_gate)
+        || findIteGate(ca, v, pos, neg, pos_gate, neg_gate);
+}
+
+
+bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause)
+{
+    merges++;
+    return mergeClauses(_ps, _qs, v, out_clause);
+}
+
+
+bool SimpSolver::merge(const Clause& _ps, const Clause& _qs, Var v, int& size)
+{
+    merges++;
+    return mergeClauses(_ps, _qs, v, size);
+}
+
+
 void SimpSolver::gatherTouchedClauses()
 {
     if (n_touched == 0) return;
@@ -339,6 +624,36 @@ bool SimpSolver::implied(const vec<Lit>& c)
 }
 
 
+// Same result as 'c.subsumes(other)', but linear in the size of 'other'. Requires the literals of
+// 'c' to be marked in 'seen' as '1 + sign(p)'.
+inline Lit SimpSolver::subsumesMarked(const Clause& c, const Clause& other) const
+{
+    if (other.size() < c.size() || (c.abstraction() & ~other.abstraction()) != 0)
+        return lit_Error;
+
+    Lit ret   = lit_Undef;
+    int found = 0;
+    for (int i = 0; i < other.size(); i++){
+        // Not enough literals left to cover 'c':
+        if (other.size() - i < c.size() - found)
+            return lit_Error;
+
+        Lit  q = other[i];
+        char s = seen[var(q)];
+        if (s == 0)
+            continue;
+        else if (s == 1 + sign(q))
+            found++;
+        else if (ret == lit_Undef)
+            ret = ~q, found++;
+        else
+            return lit_Error;
+    }
+
+    return found == c.size() ? ret : lit_Error;
+}
+
+
 // Backward subsumption + backward subsumption resolution
 bool SimpSolver::backwardSubsumptionCheck(bool verbose)
 {
@@ -382,11 +697,15 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
         vec<CRef>& _cs = occurs.lookup(best);
         CRef*       cs = (CRef*)_cs;
 
+        for (int i = 0; i < c.size(); i++)
+            seen[var(c[i])] = 1 + sign(c[i]);
+
+        // ('strengthenClause()' propagates, which may allocate clauses and move 'c': use 'ca[cr]' from here on)
         for (int j = 0; j < _cs.size(); j++)
-            if (c.mark())
+            if (ca[cr].mark())
                 break;
             else if (!ca[cs[j]].mark() &&  cs[j] != cr && (subsumption_lim == -1 || ca[cs[j]].size() < subsumption_lim)){
-                Lit l = c.subsumes(ca[cs[j]]);
+                Lit l = subsumesMarked(ca[cr], ca[cs[j]]);
 
                 if (l == lit_Undef)
                     subsumed++, removeClause(cs[j]);
@@ -401,6 +720,9 @@ bool SimpSolver::backwardSubsumptionCheck(bool verbose)
                         j--;
                 }
             }
+
+        for (int i = 0; i < ca[cr].size(); i++)
+            seen[var(ca[cr][i])] = 0;
     }
 
     return true;
@@ -458,6 +780,14 @@ static void mkElimClause(vec<uint32_t>& elimclauses, Lit x)
 }
 
 
+static void mkElimClause(vec<uint32_t>& elimclauses, Lit x, Lit y)
+{
+    elimclauses.push(toInt(x));
+    elimclauses.push(toInt(y));
+    elimclauses.push(2);
+}
+
+
 static void mkElimClause(vec<uint32_t>& elimclauses, Var v, Clause& c)
 {
     int first = elimclauses.size();
@@ -500,16 +830,51 @@ bool SimpSolver::eliminateVar(Var v)
     // Check wether the increase in number of clauses stays within the allowed ('grow'). Moreover, no
     // clause must exceed the limit on the maximal clause size (if it is set):
     //
+    // If 'v' is defined by a gate, only resolvents between gate and non-gate clauses are needed:
+    //
+    vec<char> pos_gate, neg_gate;
+    bool      gate = use_gates && findGate(ca, v, pos, neg, pos_gate, neg_gate);
+
     int cnt         = 0;
     int clause_size = 0;
 
     for (int i = 0; i < pos.size(); i++)
         for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, clause_size) && 
+            if ((!gate || pos_gate[i] != neg_gate[j]) &&
+                merge(ca[pos[i]], ca[neg[j]], v, clause_size) && 
                 (++cnt > cls.size() + grow || (clause_lim != -1 && clause_size > clause_lim)))
                 return true;
 
+    if (gate) gates++;
+
+    // The resolvents have to be in the proof before the clauses they are derived from are deleted:
+    vec<Lit>& resolvent = add_tmp;
+    if (proof.active())
+        for (int i = 0; i < pos.size(); i++)
+            for (int j = 0; j < neg.size(); j++)
+                if ((!gate || pos_gate[i] != neg_gate[j]) && merge(ca[pos[i]], ca[neg[j]], v, resolvent))
+                    proof.add(resolvent);
+
     // Delete and store old clauses:
+    removeEliminated(v, pos, neg);
+
+    // Produce clauses in cross product:
+    for (int i = 0; i < pos.size(); i++)
+        for (int j = 0; j < neg.size(); j++)
+            if ((!gate || pos_gate[i] != neg_gate[j]) &&
+                merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
+                return false;
+
+    releaseElimStorage(v);
+
+    return backwardSubsumptionCheck();
+}
+
+
+// Mark 'v' as eliminated, store the clauses needed for model extension and delete all clauses
+// containing 'v'. NOTE: the clauses are only freed lazily, so 'pos' and 'neg' may still be read.
+void SimpSolver::removeEliminated(Var v, const vec<CRef>& pos, const vec<CRef>& neg)
+{
     eliminated[v] = true;
     setDecisionVar(v, false);
     eliminated_vars++;
@@ -524,22 +889,157 @@ bool SimpSolver::eliminateVar(Var v)
         mkElimClause(elimclauses, ~mkLit(v));
     }
 
-    for (int i = 0; i < cls.size(); i++)
-        removeClause(cls[i]); 
+    for (int i = 0; i < pos.size(); i++) removeClause(pos[i]);
+    for (int i = 0; i < neg.size(); i++) removeClause(neg[i]);
+}
 
-    // Produce clauses in cross product:
-    vec<Lit>& resolvent = add_tmp;
-    for (int i = 0; i < pos.size(); i++)
-        for (int j = 0; j < neg.size(); j++)
-            if (merge(ca[pos[i]], ca[neg[j]], v, resolvent) && !addClause_(resolvent))
-                return false;
 
+void SimpSolver::releaseElimStorage(Var v)
+{
     // Free occurs list for this variable:
     occurs[v].clear(true);
     
     // Free watchers lists for this variable, if possible:
     if (watches[ mkLit(v)].size() == 0) watches[ mkLit(v)].clear(true);
     if (watches[~mkLit(v)].size() == 0) watches[~mkLit(v)].clear(true);
+}
+
+
+//=================================================================================================
+// Parallel variable elimination:
+//
+// Variables are taken from 'elim_heap' in batches such that no two variables of a batch occur in a
+// common clause. Eliminating one of them then neither changes the occurrences of the others nor
+// the resolvents produced for them, so the (read-only) resolvent computation can be distributed
+// over several threads. The results are committed sequentially in the order in which the
+// variables were taken from the heap, which makes the outcome independent of the number of
+// threads and of their scheduling.
+
+
+// Compute the resolvents of 'job.v'. Only reads the clause database, so it is safe to run
+// concurrently for independent variables as long as nothing is allocated in 'ca'.
+void SimpSolver::resolveElimJob(const ClauseAllocator& ca, ElimJob& job, int grow, int clause_lim, bool use_gates)
+{
+    vec<Lit>  resolvent;
+    vec<char> pos_gate, neg_gate;
+    int       cnt = 0;
+    int       lim = job.pos.size() + job.neg.size() + grow;
+
+    job.resolvents.clear();
+    job.eliminate = false;
+    job.merges    = 0;
+    job.gate      = use_gates && findGate(ca, job.v, job.pos, job.neg, pos_gate, neg_gate);
+    for (int i = 0; i < job.pos.size(); i++)
+        for (int j = 0; j < job.neg.size(); j++){
+            if (job.gate && pos_gate[i] == neg_gate[j]) continue;
+            job.merges++;
+            if (mergeClauses(ca[job.pos[i]], ca[job.neg[j]], job.v, resolvent)){
+                if (++cnt > lim || (clause_lim != -1 && resolvent.size() > clause_lim)){
+                    job.resolvents.clear(true);
+                    return; }
+                for (int k = 0; k < resolvent.size(); k++)
+                    job.resolvents.push(resolvent[k]);
+                job.resolvents.push(lit_Undef);
+            }
+        }
+    job.eliminate = true;
+}
+
+
+// Pick the next batch of pairwise independent variables from 'elim_heap'. Candidates that
+// share a clause with an already picked variable are put back into the heap. NOTE: the batch
+// size must not depend on 'elim_threads', otherwise the result would.
+void SimpSolver::pickElimBatch(vec<ElimJob>& batch)
+{
+    const int max_batch = 1024;
+    vec<Var>  picked, deferred;
+
+    for (int scanned = 0; !elim_heap.empty() && picked.size() < max_batch && scanned < 4 * max_batch; scanned++){
+        Var v = elim_heap.removeMin();
+        if (isEliminated(v) || value(v) != l_Undef || frozen[v]) continue;
+
+        if (seen[v]){
+            deferred.push(v);
+            continue; }
+
+        // Mark the neighbourhood of 'v':
+        const vec<CRef>& cls = occurs.lookup(v);
+        for (int i = 0; i < cls.size(); i++){
+            const Clause& c = ca[cls[i]];
+            for (int j = 0; j < c.size(); j++)
+                seen[var(c[j])] = 1;
+        }
+        seen[v] = 1;
+        picked.push(v);
+    }
+
+    batch.clear();
+    batch.growTo(picked.size());
+    for (int i = 0; i < picked.size(); i++){
+        ElimJob&         job = batch[i];
+        const vec<CRef>& cls = occurs[picked[i]];
+        job.v = picked[i];
+        job.pos.clear();
+        job.neg.clear();
+        for (int j = 0; j < cls.size(); j++)
+            (find(ca[cls[j]], mkLit(job.v)) ? job.pos : job.neg).push(cls[j]);
+
+        for (int j = 0; j < cls.size(); j++){
+            const Clause& c = ca[cls[j]];
+            for (int k = 0; k < c.size(); k++)
+                seen[var(c[k])] = 0;
+        }
+        seen[job.v] = 0;
+    }
+
+    for (int i = 0; i < deferred.size(); i++)
+        elim_heap.insert(deferred[i]);
+}
+
+
+bool SimpSolver::eliminateBatch(vec<ElimJob>& batch)
+{
+    // Compute resolvents in parallel:
+    std::atomic<int> next(0);
+    auto worker = [&](){
+        for (int i; (i = next++) < batch.size();)
+            resolveElimJob(ca, batch[i], grow, clause_lim, use_gates);
+    };
+
+    int n_threads = std::min(elim_threads, batch.size());
+    std::vector<std::thread> threads;
+    for (int t = 1; t < n_threads; t++)
+        threads.emplace_back(worker);
+    worker();
+    for (std::thread& t : threads)
+        t.join();
+
+    // Commit in deterministic order:
+    for (int i = 0; i < batch.size(); i++){
+        ElimJob& job = batch[i];
+        merges += job.merges;
+
+        if (!job.eliminate || value(job.v) != l_Undef) continue;
+
+        if (job.gate) gates++;
+        if (proof.active())
+            for (int j = 0, k; j < job.resolvents.size(); j = k + 1){
+                for (k = j; job.resolvents[k] != lit_Undef; k++);
+                proof.add(&job.resolvents[j], k - j); }
+        removeEliminated(job.v, job.pos, job.neg);
+
+        vec<Lit>& resolvent = add_tmp;
+        for (int j = 0; j < job.resolvents.size(); j++){
+            resolvent.clear();
+            for (; job.resolvents[j] != lit_Undef; j++)
+                resolvent.push(job.resolvents[j]);
+            if (!addClause_(resolvent))
+                return false;
+        }
+        job.resolvents.clear(true);
+
+        releaseElimStorage(job.v);
+    }
 
     return backwardSubsumptionCheck();
 }
@@ -555,7 +1055,20 @@ bool SimpSolver::substitute(Var v, Lit x)
 
     eliminated[v] = true;
     setDecisionVar(v, false);
+    substituted_vars++;
+
+    // Store the equivalence for model extension:
+    mkElimClause(elimclauses,  mkLit(v), ~x);
+    mkElimClause(elimclauses, ~mkLit(v),  x);
+
     const vec<CRef>& cls = occurs.lookup(v);
+
+    // The equivalence may only be implied through a chain of binary clauses; make it direct so the
+    // substituted clauses follow by unit propagation, even after some of the chain is deleted:
+    Lit equiv[2][2] = { { ~mkLit(v), x }, { mkLit(v), ~x } };
+    if (proof.active()){
+        proof.add(equiv[0], 2);
+        proof.add(equiv[1], 2); }
     
     vec<Lit>& subst_clause = add_tmp;
     for (int i = 0; i < cls.size(); i++){
@@ -567,16 +1080,149 @@ bool SimpSolver::substitute(Var v, Lit x)
             subst_clause.push(var(p) == v ? x ^ sign(p) : p);
         }
 
+        // Log the substituted clause before the original one is deleted (unless it is a tautology,
+        // in which case it is dropped by 'addClause_()' anyway):
+        if (proof.active()){
+            sort(subst_clause);
+            int k;
+            for (k = 1; k < subst_clause.size() && subst_clause[k] != ~subst_clause[k-1]; k++);
+            if (k >= subst_clause.size())
+                proof.add(subst_clause);
+        }
+
         removeClause(cls[i]);
 
         if (!addClause_(subst_clause))
             return ok = false;
     }
 
+    if (proof.active()){
+        proof.remove(equiv[0], 2);
+        proof.remove(equiv[1], 2); }
+
     return true;
 }
 
 
+// Find equivalent literals as the strongly connected components of the binary implication graph
+// (Tarjan's algorithm, iterative to not overflow the stack on long implication chains) and
+// substitute every variable of a component by a representative. Frozen variables are preferred
+// as representatives, otherwise the smallest variable is picked; frozen variables that are not
+// representatives are kept as they are.
+bool SimpSolver::substituteEquivalences()
+{
+    assert(decisionLevel() == 0);
+    int n = 2*nVars();
+
+    // Build the implication graph in compressed form: the successors of 'p' are
+    // 'succ[start[toInt(p)] .. start[toInt(p)+1]-1]'.
+    vec<int> start(n + 1, 0), fill;
+    vec<Lit> succ;
+    for (int pass = 0; pass < 2; pass++){
+        if (pass == 1){
+            for (int i = 0; i < n; i++) start[i+1] += start[i];
+            start.copyTo(fill);
+            succ.growTo(start[n]);
+        }
+        for (int i = 0; i < clauses.size(); i++){
+            const Clause& c = ca[clauses[i]];
+            if (c.mark() != 0 || c.size() != 2 || value(c[0]) != l_Undef || value(c[1]) != l_Undef)
+                continue;
+            if (pass == 0){
+                start[toInt(~c[0]) + 1]++;
+                start[toInt(~c[1]) + 1]++;
+            }else{
+                succ[fill[toInt(~c[0])]++] = c[1];
+                succ[fill[toInt(~c[1])]++] = c[0];
+            }
+        }
+    }
+    if (succ.size() == 0)
+        return true;
+
+    vec<int>  index  (n, -1);
+    vec<int>  lowlink(n, 0);
+    vec<int>  comp   (n, -1);    // Component number of each literal, once it is complete.
+    vec<Lit>  stack, members;
+    vec<int>  dfs_node, dfs_edge;
+    vec<Lit>  repr(n, lit_Undef);
+    int       next_index = 0, ncomps = 0;
+
+    for (int root = 0; root < n; root++){
+        if (index[root] != -1 || start[root] == start[root+1]) continue;
+
+        dfs_node.push(root); dfs_edge.push(start[root]);
+        index[root] = lowlink[root] = next_index++;
+        stack.push(toLit(root));
+
+        while (dfs_node.size() > 0){
+            int u = dfs_node.last();
+            int e = dfs_edge.last();
+            if (e < start[u+1]){
+                dfs_edge.last()++;
+                int w = toInt(succ[e]);
+                if (index[w] == -1){
+                    index[w] = lowlink[w] = next_index++;
+                    stack.push(succ[e]);
+                    dfs_node.push(w); dfs_edge.push(start[w]);
+                }else if (comp[w] == -1 && index[w] < lowlink[u])
+                    lowlink[u] = index[w];
+                continue;
+            }
+
+            dfs_node.pop(); dfs_edge.pop();
+            if (dfs_node.size() > 0 && lowlink[u] < lowlink[dfs_node.last()])
+                lowlink[dfs_node.last()] = lowlink[u];
+            if (lowlink[u] != index[u]) continue;
+
+            // 'u' is the root of a component; pop its members and pick a representative:
+            members.clear();
+            Lit p;
+            do {
+                p = stack.last(); stack.pop();
+                comp[toInt(p)] = ncomps;
+                members.push(p);
+            } while (toInt(p) != u);
+            ncomps++;
+
+            if (members.size() == 1) continue;
+
+            Lit r = members[0];
+            for (int i = 1; i < members.size(); i++){
+                Lit q = members[i];
+                if ((frozen[var(q)] && !frozen[var(r)]) || (frozen[var(q)] == frozen[var(r)] && var(q) < var(r)))
+                    r = q;
+            }
+            for (int i = 0; i < members.size(); i++){
+                if (comp[toInt(~members[i])] == ncomps - 1){
+                    // Both 'x' and '~x' in the same component ('x' is implied by '~x'):
+                    proof.add(members[i]);
+                    return false; }
+                repr[toInt(members[i])] = r;
+            }
+        }
+    }
+
+    // Substitute. Each component is handled via the literal of its representative that is
+    // positive, which visits each equivalence class exactly once:
+    int substituted_before = substituted_vars;
+    for (Var v = 0; v < nVars(); v++){
+        Lit r = repr[toInt(mkLit(v))];
+        if (r == lit_Undef || var(r) == v || frozen[v] || isEliminated(v) || value(v) != l_Undef)
+            continue;
+        if (value(r) != l_Undef || isEliminated(var(r)))
+            continue;
+        if (!substitute(v, r))
+            return false;
+    }
+
+    if (verbosity >= 2)
+        printf("|  Equivalent literals:  %12d                                         |\n", substituted_vars - substituted_before);
+
+    return propagate() == CRef_Undef;
+}
+
+
 void SimpSolver::extendModel()
 {
     int i, j;
@@ -596,11 +1242,19 @@ void SimpSolver::extendModel()
 
 bool SimpSolver::eliminate(bool turn_off_elim)
 {
+    PhaseTimer timer(time_eliminate, stats_timers, true);
     if (!simplify())
         return false;
     else if (!use_simplification)
         return true;
 
+    // Probing before the search; later rounds are scheduled by 'inprocess()':
+    if (use_probing && inprocessings == 0 && !probe(probe_budget)){
+        ok = false; goto cleanup; }
+
+    if (use_equiv && !substituteEquivalences()){
+        ok = false; goto cleanup; }
+
     // Main simplification loop:
     //
     while (n_touched > 0 || bwdsub_assigns < trail.size() || elim_heap.size() > 0){
@@ -620,6 +1274,20 @@ bool SimpSolver::eliminate(bool turn_off_elim)
             goto cleanup; }
 
         // printf("  ## (time = %6.2f s) ELIM: vars = %d\n", cpuTime(), elim_heap.size());
+        if (use_elim && !use_asymm && elim_threads > 1){
+            vec<ElimJob> batch;
+            while (!elim_heap.empty() && !asynch_interrupt){
+                if (verbosity >= 2)
+                    printf("elimination left: %10d\r", elim_heap.size());
+
+                pickElimBatch(batch);
+                if (!eliminateBatch(batch)){
+                    ok = false; goto cleanup; }
+
+                checkGarbage(simp_garbage_frac);
+            }
+        }
+
         for (int cnt = 0; !elim_heap.empty(); cnt++){
             Var elim = elim_heap.removeMin();
             
@@ -648,6 +1316,9 @@ bool SimpSolver::eliminate(bool turn_off_elim)
 
         assert(subsumption_queue.size() == 0);
     }
+
+    if (learnts.size() > 0)
+        removeEliminatedLearnts();
  cleanup:
 
     // If no more simplification is needed, free all simplification-related data structures:
@@ -671,7 +1342,8 @@ bool SimpSolver::eliminate(bool turn_off_elim)
         checkGarbage();
     }
 
-    if (verbosity >= 1 && elimclauses.size() > 0)
+    // (not from the rounds of 'inprocess()', in the middle of the search progress table)
+    if (verbosity >= 1 && inprocessings == 0 && elimclauses.size() > 0)
         printf("|  Eliminated clauses:     %10.2f Mb                                      |\n", 
                double(elimclauses.size() * sizeof(uint32_t)) / (1024*1024));
 
@@ -679,6 +1351,108 @@ bool SimpSolver::eliminate(bool turn_off_elim)
 }
 
 
+// Learnt clauses are not part of the occurrence lists. Remove the ones that still refer to
+// eliminated variables:
+void SimpSolver::removeEliminatedLearnts()
+{
+    int i, j;
+    for (i = j = 0; i < learnts.size(); i++){
+        Clause& c = ca[learnts[i]];
+        int k;
+        for (k = 0; k < c.size() && !isEliminated(var(c[k])); k++);
+        if (k < c.size() && !c.persistent() && !locked(c))
+            Solver::removeClause(learnts[i]);
+        else
+            learnts[j++] = learnts[i];
+    }
+    learnts.shrink(i - j);
+}
+
+
+// Re-run variable elimination on the formula strengthened by the units and learnt clauses found
+// so far. Only possible while the simplification data structures are still alive, i.e. if the
+// first call to 'eliminate()' did not turn them off.
+bool SimpSolver::inprocess()
+{
+    if (!Solver::inprocess())
+        return false;
+    if (!use_simplification)
+        return true;
+
+    double start_time = cpuTime();
+    int    elim_before = eliminated_vars + substituted_vars;
+    stats_elim.runs++;
+
+    // Assumptions must be temporarily frozen to run variable elimination:
+    vec<Var> extra_frozen;
+    for (int i = 0; i < assumptions.size(); i++){
+        Var v = var(assumptions[i]);
+        if (!frozen[v]){
+            setFrozen(v, true);
+            extra_frozen.push(v); } }
+
+    bool res = eliminate(false);
+
+    for (int i = 0; i < extra_frozen.size(); i++)
+        setFrozen(extra_frozen[i], false);
+
+    stats_elim.clauses += eliminated_vars + substituted_vars - elim_before;
+    stats_elim.time    += cpuTime() - start_time;
+    return res;
+}
+
+
+//=================================================================================================
+// Checkpoints:
+
+
+// Appends the eliminated variables and the clauses needed to extend models to them:
+void SimpSolver::writeState(FILE* f)
+{
+    Solver::writeState(f);
+
+    bcnfPutVarint(f, eliminated_vars);
+    bcnfPutVarint(f, substituted_vars);
+    for (Var v = 0; v < nVars(); v++)
+        putc(eliminated[v], f);
+    bcnfPutVarint(f, elimclauses.size());
+    for (int i = 0; i < elimclauses.size(); i++)
+        bcnfPutVarint(f, elimclauses[i]);
+    bcnfPut32(f, ckpt_tag);
+}
+
+
+// A resumed solver does not run variable elimination again; the occurrence lists would have to
+// be rebuilt from scratch:
+bool SimpSolver::readState(FILE* f)
+{
+    touched  .clear(true);
+    occurs   .clear(true);
+    n_occ    .clear(true);
+    elim_heap.clear(true);
+    subsumption_queue.clear(true);
+
+    use_simplification    = false;
+    remove_satisfied      = true;
+    ca.extra_clause_field = false;
+
+    if (!Solver::readState(f))
+        return false;
+    max_simp_var = nVars();
+
+    CheckpointReader in(f);
+    eliminated_vars  = (int)in.getVarint();
+    substituted_vars = (int)in.getVarint();
+    for (Var v = 0; v < nVars(); v++){
+        frozen    .insert(v, (char)false);
+        eliminated.insert(v, (char)(in.get8() != 0)); }
+    int n = (int)in.getVarint();
+    for (int i = 0; i < n && in.ok; i++)
+        elimclauses.push(in.getVarint());
+    return in.endSection();
+}
+
+
 //=================================================================================================
 // Garbage Collection methods:
 
@@ -711,8 +1485,22 @@ void SimpSolver::relocAll(ClauseAllocator& to)
 }
 
 
+void SimpSolver::collectStats(SolverStats& out) const
+{
+    Solver::collectStats(out);
+    out.add("simp.eliminated_vars", (uint64_t)eliminated_vars);
+    out.add("simp.substituted_vars", (uint64_t)substituted_vars);
+    out.add("simp.gates", (uint64_t)gates);
+    out.add("simp.merges", (uint64_t)merges);
+    out.add("simp.asymm_lits", (uint64_t)asymm_lits);
+    out.add("time.eliminate", time_eliminate);
+}
+
+
 void SimpSolver::garbageCollect()
 {
+    PhaseTimer timer(time_gc, stats_timers, true);
+
     // Initialize the next region to a size corresponding to the estimated utilization degree. This
     // is not precise but should avoid some unnecessary reallocations for the new region:
     ClauseAllocator to(ca.size() - ca.wasted()); 
@@ -48,6 +48,10 @@ class SimpSolver : public Solver {
     bool    addClause (Lit p, Lit q, Lit r); // Add a ternary clause to the solver.
     bool    addClause (Lit p, Lit q, Lit r, Lit s); // Add a quaternary clause to the solver. 
     bool    addClause_(      vec<Lit>& ps);
+    bool    addClauses(const vec<Lit>& lits, const vec<int>& offsets, int threads = 1); // Add many clauses at once (see 'Solver::addClauses()').
+    bool    addClauses(const Lit* lits, const int* offsets, int n_clauses, int threads = 1);
+    bool    addAtMost (const vec<Lit>& ps, int k); // Add an at-most constraint (see 'Solver::addAtMost()'); freezes its variables.
+    bool    addXor    (const vec<Lit>& ps);        // Add an XOR constraint (see 'Solver::addXor()'); freezes its variables.
     bool    substitute(Var v, Lit x);  // Replace all occurences of v with x (may cause a contradiction).
 
     // Variable mode:
@@ -74,6 +78,8 @@ class SimpSolver : public Solver {
     //
     virtual void garbageCollect();
 
+    virtual void collectStats(SolverStats& out) const; // Adds the simplification statistics (see 'Solver::collectStats()').
+
 
     // Generate a (possibly simplified) DIMACS file:
     //
@@ -92,10 +98,13 @@ class SimpSolver : public Solver {
                                // -1 means no limit.
     int     subsumption_lim;   // Do not check if subsumption against a clause larger than this. -1 means no limit.
     double  simp_garbage_frac; // A different limit for when to issue a GC during simplification (Also see 'garbage_frac').
+    int     elim_threads;      // Number of threads used to compute resolvents during variable elimination (1 = sequential).
 
     bool    use_asymm;         // Shrink clauses by asymmetric branching.
     bool    use_rcheck;        // Check if a clause is already implied. Prett costly, and subsumes subsumptions :)
     bool    use_elim;          // Perform variable elimination.
+    bool    use_equiv;         // Substitute equivalent literals found in the binary implication graph.
+    bool    use_gates;         // Only produce gate/non-gate resolvents when eliminating a variable defined by a gate.
     bool    extend_model;      // Flag to indicate whether the user needs to look at the full model.
 
     // Statistics:
@@ -103,6 +112,9 @@ class SimpSolver : public Solver {
     int     merges;
     int     asymm_lits;
     int     eliminated_vars;
+    int     substituted_vars;
+    int     gates;
+    PhaseTime time_eliminate;  // (counted if 'stats_timers' is set)
 
  protected:
 
@@ -124,6 +136,16 @@ class SimpSolver : public Solver {
         //     return c_x < c_y || c_x == c_y && x < y; }
     };
 
+    // A variable elimination prepared for parallel resolvent computation:
+    struct ElimJob {
+        Var       v;
+        vec<CRef> pos, neg;       // Clauses containing 'v' positively/negatively.
+        vec<Lit>  resolvents;     // Non-tautological resolvents, each terminated by 'lit_Undef'.
+        int       merges;
+        bool      gate;           // TRUE if 'v' is defined by a gate (only gate/non-gate resolvents were produced).
+        bool      eliminate;      // FALSE if the elimination would exceed 'grow' or 'clause_lim'.
+    };
+
     struct ClauseDeleted {
         const ClauseAllocator& ca;
         explicit ClauseDeleted(const ClauseAllocator& _ca) : ca(_ca) {}
@@ -154,20 +176,32 @@ class SimpSolver : public Solver {
     // Main internal methods:
     //
     lbool         solve_                   (bool do_simp = true, bool turn_off_simp = false);
+    bool          inprocess                ();
     bool          asymm                    (Var v, CRef cr);
     bool          asymmVar                 (Var v);
+    bool          substituteEquivalences   ();
+    void          addOccurrences           (CRef cr);
+    void          removeEliminatedLearnts  ();
     void          updateElimHeap           (Var v);
     void          gatherTouchedClauses     ();
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, vec<Lit>& out_clause);
     bool          merge                    (const Clause& _ps, const Clause& _qs, Var v, int& size);
     bool          backwardSubsumptionCheck (bool verbose = false);
+    Lit           subsumesMarked           (const Clause& c, const Clause& other) const;
     bool          eliminateVar             (Var v);
+    void          removeEliminated         (Var v, const vec<CRef>& pos, const vec<CRef>& neg);
+    void          releaseElimStorage       (Var v);
+    void          pickElimBatch            (vec<ElimJob>& batch);
+    bool          eliminateBatch           (vec<ElimJob>& batch);
+    static void   resolveElimJob           (const ClauseAllocator& ca, ElimJob& job, int grow, int clause_lim, bool use_gates);
     void          extendModel              ();
 
     void          removeClause             (CRef cr);
     bool          strengthenClause         (CRef cr, Lit l);
     bool          implied                  (const vec<Lit>& c);
     void          relocAll                 (ClauseAllocator& to);
+    void          writeState               (FILE* f);
+    bool          readState                (FILE* f);
 };
 
 
@@ -189,6 +223,8 @@ inline bool SimpSolver::addClause    (Lit p)                 { add_tmp.clear();
 inline bool SimpSolver::addClause    (Lit p, Lit q)          { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); return addClause_(add_tmp); }
 inline bool SimpSolver::addClause    (Lit p, Lit q, Lit r)   { add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); return addClause_(add_tmp); }
 inline bool SimpSolver::addClause    (Lit p, Lit q, Lit r, Lit s){ add_tmp.clear(); add_tmp.push(p); add_tmp.push(q); add_tmp.push(r); add_tmp.push(s); return addClause_(add_tmp); }
+inline bool SimpSolver::addClauses   (const vec<Lit>& lits, const vec<int>& offsets, int threads){
+    return offsets.size() <= 1 ? ok : addClauses(lits.size() > 0 ? &lits[0] : NULL, &offsets[0], offsets.size() - 1, threads); }
 inline void SimpSolver::setFrozen    (Var v, bool b) { frozen[v] = (char)b; if (use_simplification && !b) { updateElimHeap(v); } }
 
 inline void SimpSolver::freezeVar(Var v){
@@ -0,0 +1,236 @@
+#include <errno.h>
+#include <string.h>
+
+#include "src/mtl/Vec.h"
+#include "src/utils/Options.h"
+#include "src/utils/Trace.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Summaries of search event traces (see 'Trace.h'), and comparisons of two traces:
+
+
+// Conflicts at the last record of the trace 'path' (0 if it is empty or can not be read):
+static uint64_t lastConflicts(const char* path)
+{
+    TraceRecord r;
+    FILE*       in = fopen(path, "rb");
+    bool        ok = in != NULL && fseek(in, -(long)sizeof(TraceRecord), SEEK_END) == 0 && ftell(in) >= (long)sizeof(trace_magic)
+                  && fread(&r, sizeof(TraceRecord), 1, in) == 1;
+    if (in != NULL) fclose(in);
+    return ok ? r.conflicts : 0;
+}
+
+
+class TraceReader {
+    FILE*       in;
+    TraceRecord buf[4096];
+    int         pos, len;
+public:
+    TraceReader() : in(NULL), pos(0), len(0) {}
+    ~TraceReader() { if (in != NULL) fclose(in); }
+
+    // Exits with an error message if 'path' is not a trace:
+    void open(const char* path) {
+        char magic[sizeof(trace_magic)];
+        if ((in = fopen(path, "rb")) == NULL)
+            fprintf(stderr, "ERROR! Could not open file: %s (%s)\n", path, strerror(errno)), exit(1);
+        if (fread(magic, 1, sizeof(magic), in) != sizeof(magic) || memcmp(magic, trace_magic, sizeof(magic)) != 0)
+            fprintf(stderr, "ERROR! Not a trace file: %s\n", path), exit(1); }
+
+    bool next(TraceRecord& r) {
+        if (pos == len){
+            pos = 0;
+            len = (int)fread(buf, sizeof(TraceRecord), sizeof(buf) / sizeof(TraceRecord), in);
+            if (len == 0) return false; }
+        r = buf[pos++];
+        return true; }
+};
+
+
+// Aggregates over the records of a trace, in total and per window of conflicts:
+struct Window {
+    uint64_t decisions, conflicts, learnt_lits, lbds, restarts;
+    Window() : decisions(0), conflicts(0), learnt_lits(0), lbds(0), restarts(0) {}
+};
+
+enum { lbd_buckets = 6 };   // LBD 1, 2, 3-4, 5-8, 9-16, more
+
+struct Summary {
+    uint64_t    records, decisions, conflicts, restarts, reductions, solves;
+    uint64_t    learnt_lits, lbds, levels, jumps, removed, kept;
+    uint64_t    lbd_hist[lbd_buckets];
+    vec<Window> windows;
+    Summary() : records(0), decisions(0), conflicts(0), restarts(0), reductions(0), solves(0),
+                learnt_lits(0), lbds(0), levels(0), jumps(0), removed(0), kept(0) {
+        for (int i = 0; i < lbd_buckets; i++) lbd_hist[i] = 0; }
+
+    void add(const TraceRecord& r, uint64_t window) {
+        records++;
+        windows.growTo((int)(r.conflicts / window) + 1);
+        Window& w = windows[(int)(r.conflicts / window)];
+        switch (r.kind){
+        case trace_decision: decisions++; w.decisions++; break;
+        case trace_conflict: {
+            conflicts++;   w.conflicts++;
+            learnt_lits += r.a; w.learnt_lits += r.a;
+            lbds        += r.b; w.lbds        += r.b;
+            levels      += r.level;
+            jumps       += r.level - r.c;
+            int b = 0;
+            while (b < lbd_buckets - 1 && r.b > (1u << b)) b++;
+            lbd_hist[b]++;
+            break; }
+        case trace_restart:  restarts++; w.restarts++; break;
+        case trace_reduce:   reductions++; removed += r.a; kept += r.b; break;
+        case trace_solve:    solves++; break;
+        }
+    }
+};
+
+
+static void summarize(const char* path, uint64_t window, Summary& s)
+{
+    TraceReader in;
+    TraceRecord r;
+    in.open(path);
+    while (in.next(r))
+        s.add(r, window);
+}
+
+
+static double ratio(uint64_t x, uint64_t y) { return y == 0 ? 0 : (double)x / y; }
+
+// One line of a table; 'b' is printed (with the change relative to 'a') only when comparing:
+static void row(const char* name, int decimals, double a, const double* b)
+{
+    printf("%-24s %14.*f", name, decimals, a);
+    if (b != NULL){
+        printf(" %14.*f", decimals, *b);
+        if (a != 0) printf("   %+7.1f %%", (*b - a) * 100 / a);
+    }
+    printf("\n");
+}
+
+static void printSummary(const Summary& main, const Summary* other)
+{
+    static const char* lbd_names[lbd_buckets] = { "  LBD 1 (%)", "  LBD 2 (%)", "  LBD 3-4 (%)", "  LBD 5-8 (%)", "  LBD 9-16 (%)", "  LBD > 16 (%)" };
+    printf("%-24s %14s%s\n", "", "A", other ? "              B   (B-A)/A" : "");
+
+    // (the expression is evaluated for 'main' and for 'other', both named 's')
+#define ROW(name, decimals, expr) do { double x, y = 0; { const Summary& s = main; x = (expr); } \
+                                       if (other){ const Summary& s = *other; y = (expr); } \
+                                       row(name, decimals, x, other ? &y : NULL); } while (0)
+    ROW("records",               0, s.records);
+    ROW("conflicts",             0, s.conflicts);
+    ROW("decisions",             0, s.decisions);
+    ROW("  per conflict",        2, ratio(s.decisions, s.conflicts));
+    ROW("learnt size (avg)",     2, ratio(s.learnt_lits, s.conflicts));
+    ROW("LBD (avg)",             2, ratio(s.lbds, s.conflicts));
+    for (int i = 0; i < lbd_buckets; i++)
+        ROW(lbd_names[i],        2, ratio(s.lbd_hist[i] * 100, s.conflicts));
+    ROW("conflict level (avg)",  2, ratio(s.levels, s.conflicts));
+    ROW("backjump (avg)",        2, ratio(s.jumps, s.conflicts));
+    ROW("restarts",              0, s.restarts);
+    ROW("  conflicts between",   2, ratio(s.conflicts, s.restarts));
+    ROW("reductions",            0, s.reductions);
+    ROW("  removed (avg)",       2, ratio(s.removed, s.reductions));
+    ROW("  kept (avg)",          2, ratio(s.kept, s.reductions));
+    ROW("solve calls",           0, s.solves);
+#undef ROW
+}
+
+
+static void printWindows(const Summary& a, const Summary* b, uint64_t window)
+{
+    int n = a.windows.size();
+    if (b != NULL && b->windows.size() > n) n = b->windows.size();
+    printf("\nper %" PRIu64 " conflicts:      decisions/conflict    learnt size        LBD        restarts\n", window);
+    for (int i = 0; i < n; i++){
+        for (int k = 0; k < (b != NULL ? 2 : 1); k++){
+            const Summary& s = k == 0 ? a : *b;
+            Window         w = i < s.windows.size() ? s.windows[i] : Window();
+            if (k == 0) printf("%10" PRIu64 " ", (uint64_t)i * window);
+            else        printf("%10s ", "");
+            printf("%s %18.2f %14.2f %10.2f %15" PRIu64 "\n", b == NULL ? " " : k == 0 ? "A" : "B",
+                   ratio(w.decisions, w.conflicts), ratio(w.learnt_lits, w.conflicts), ratio(w.lbds, w.conflicts), w.restarts);
+        }
+    }
+}
+
+
+static const char* kindName(uint32_t kind)
+{
+    switch (kind){
+    case trace_decision: return "decision";
+    case trace_conflict: return "conflict";
+    case trace_restart:  return "restart";
+    case trace_reduce:   return "reduce";
+    case trace_solve:    return "solve";
+    default:             return "?";
+    }
+}
+
+
+static void printRecord(const char* name, const TraceRecord& r)
+{
+    printf("  %s: %-8s at conflict %" PRIu64 ", level %u: %u %u %u\n", name, kindName(r.kind), r.conflicts, r.level, r.a, r.b, r.c);
+}
+
+
+// Reports the first record where the traces differ (the point where the searches took different turns):
+static void printDivergence(const char* path_a, const char* path_b)
+{
+    TraceReader a, b;
+    TraceRecord ra, rb;
+    a.open(path_a);
+    b.open(path_b);
+    for (uint64_t i = 0;; i++){
+        bool more_a = a.next(ra), more_b = b.next(rb);
+        if (!more_a && !more_b){
+            printf("\nthe traces are identical\n");
+            return; }
+        if (more_a != more_b || memcmp(&ra, &rb, sizeof(TraceRecord)) != 0){
+            printf("\nthe traces diverge at record %" PRIu64 ":\n", i);
+            if (more_a) printRecord("A", ra); else printf("  A: (end of trace)\n");
+            if (more_b) printRecord("B", rb); else printf("  B: (end of trace)\n");
+            return; }
+    }
+}
+
+
+//=================================================================================================
+// Main:
+
+
+int main(int argc, char** argv)
+{
+    setUsageHelp("USAGE: %s [options] <trace> [<other-trace>]\n\n"
+                  "  Summarizes a search event trace (recorded with '-trace' by a solver built with MINISAT_TRACE),\n"
+                  "  or compares two traces: A (the first) and B.\n");
+
+    IntOption window_opt("MAIN", "window", "Conflicts per line of the timeline (0 = a tenth of the conflicts).", 0, IntRange(0, INT32_MAX));
+    BoolOption timeline ("MAIN", "timeline", "Print the timeline.", true);
+
+    parseOptions(argc, argv, true);
+    if (argc != 2 && argc != 3)
+        printUsageAndExit(argc, argv);
+
+    uint64_t window = window_opt;
+    if (window == 0){
+        uint64_t last = lastConflicts(argv[1]);
+        if (argc == 3 && lastConflicts(argv[2]) > last) last = lastConflicts(argv[2]);
+        window = last / 10 > 0 ? last / 10 : 1; }
+
+    Summary a, b;
+    summarize(argv[1], window, a);
+    if (argc == 3) summarize(argv[2], window, b);
+
+    printSummary(a, argc == 3 ? &b : NULL);
+    if (timeline)
+        printWindows(a, argc == 3 ? &b : NULL, window);
+    if (argc == 3)
+        printDivergence(argv[1], argv[2]);
+    return 0;
+}
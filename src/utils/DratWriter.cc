@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <utility>
+
+#include "src/mtl/XAlloc.h"
+#include "src/utils/DratWriter.h"
+
+using namespace Minisat;
+
+
+DratWriter::DratWriter() :
+    out(NULL), binary(true), failed(false), buf(NULL), len(0), cap(0),
+    pending(NULL), pending_len(0), pending_cap(0), stopping(false)
+{}
+
+
+bool DratWriter::open(const char* path, bool binary_)
+{
+    close();
+    if ((out = fopen(path, binary_ ? "wb" : "w")) == NULL)
+        return false;
+
+    binary      = binary_;
+    failed      = false;
+    stopping    = false;
+    cap         = pending_cap = buffer_size + 1024;
+    buf         = (unsigned char*)xrealloc(NULL, cap);
+    pending     = (unsigned char*)xrealloc(NULL, pending_cap);
+    len         = pending_len = 0;
+    writer      = std::thread(&DratWriter::writerLoop, this);
+    return true;
+}
+
+
+bool DratWriter::close()
+{
+    if (out == NULL) return true;
+
+    submit();
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    cv.notify_all();
+    writer.join();
+
+    if (fclose(out) != 0) failed = true;
+    out = NULL;
+    free(buf);     buf     = NULL;
+    free(pending); pending = NULL;
+    return !failed;
+}
+
+
+// Make room for 'bytes' more bytes in the current buffer:
+void DratWriter::reserve(int bytes)
+{
+    if (len + bytes <= cap) return;
+    submit();
+    if (bytes > cap){
+        // A single step larger than the buffer (a very long clause):
+        cap = bytes;
+        buf = (unsigned char*)xrealloc(buf, cap);
+    }
+}
+
+
+// Hand the current buffer over to the writer thread, waiting for it to finish the previous one:
+void DratWriter::submit()
+{
+    if (len == 0) return;
+
+    std::unique_lock<std::mutex> lock(mtx);
+    cv.wait(lock, [&]{ return pending_len == 0; });
+    std::swap(buf, pending);
+    std::swap(cap, pending_cap);
+    pending_len = len;
+    len         = 0;
+    cv.notify_all();
+}
+
+
+void DratWriter::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(mtx);
+    for (;;){
+        cv.wait(lock, [&]{ return pending_len > 0 || stopping; });
+        if (pending_len == 0) return;
+
+        // The pending buffer is not touched by the solver thread until 'pending_len' is reset:
+        lock.unlock();
+        if (fwrite(pending, 1, pending_len, out) != (size_t)pending_len)
+            failed = true;
+        lock.lock();
+
+        pending_len = 0;
+        cv.notify_all();
+    }
+}
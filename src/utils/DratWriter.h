@@ -0,0 +1,119 @@
+#ifndef Minisat_DratWriter_h
+#define Minisat_DratWriter_h
+
+#include <stdio.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "src/core/SolverTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// DRAT proof output:
+//
+// Clause additions and deletions are encoded into a memory buffer by the solver thread. Full
+// buffers are handed to a background thread that writes them out, so the solver only waits for
+// the disk if it produces proof steps faster than they can be written. Both the binary format
+// ('a'/'d' followed by variable-length encoded literals and a 0 byte) and the textual format
+// are supported.
+
+
+class DratWriter {
+public:
+    DratWriter();
+    ~DratWriter() { close(); }
+
+    bool open  (const char* path, bool binary = true); // FALSE if the file could not be opened.
+    bool close ();                                     // Write out everything. FALSE on write errors.
+    bool active() const { return out != NULL; }
+    void abandon()      { out = NULL; }                // Stop logging without writing anything (in a forked child,
+                                                       // where the writer thread does not exist).
+
+    // Log the clause 'c' (without the literal 'except', if given) as added or deleted:
+    template<class Lits> void add   (const Lits& c, Lit except = lit_Undef) { step('a', c, c.size(), except); }
+    template<class Lits> void remove(const Lits& c, Lit except = lit_Undef) { step('d', c, c.size(), except); }
+    void                      add   (const Lit* c, int size)                { step('a', c, size, lit_Undef); }
+    void                      remove(const Lit* c, int size)                { step('d', c, size, lit_Undef); }
+    void                      add   (Lit p)                                 { step('a', &p, 1, lit_Undef); }
+
+private:
+    enum { buffer_size = 1024*1024 };
+
+    FILE*                   out;
+    bool                    binary;
+    bool                    failed;
+
+    unsigned char*          buf;        // Filled by the solver thread.
+    int                     len;
+    int                     cap;
+    unsigned char*          pending;    // Being written by the writer thread (if 'pending_len > 0').
+    int                     pending_len;
+    int                     pending_cap;
+
+    std::thread             writer;
+    std::mutex              mtx;
+    std::condition_variable cv;
+    bool                    stopping;
+
+    void put(unsigned char b) { buf[len++] = b; }
+    void putLit(Lit p);
+    void reserve(int bytes);
+    void submit();
+    void writerLoop();
+
+    template<class Lits>
+    void step(char kind, const Lits& c, int size, Lit except) {
+        if (out == NULL) return;
+        reserve(12 * (size + 2));
+        if (binary)
+            put((unsigned char)kind);
+        else if (kind == 'd'){
+            put('d'); put(' '); }
+        for (int i = 0; i < size; i++)
+            if (c[i] != except)
+                putLit(c[i]);
+        if (binary)
+            put(0);
+        else{
+            put('0'); put('\n'); }
+        if (len >= buffer_size)
+            submit();
+    }
+
+    // Don't allow copying:
+    DratWriter(const DratWriter&);
+    DratWriter& operator=(const DratWriter&);
+};
+
+
+//=================================================================================================
+// Implementation of inline methods:
+
+
+inline void DratWriter::putLit(Lit p)
+{
+    if (binary){
+        // Variable-length encoding of '2*(var+1) + sign', 7 bits per byte:
+        uint32_t x = 2*(var(p) + 1) + sign(p);
+        while (x >= 0x80){
+            put((unsigned char)(x & 0x7f) | 0x80);
+            x >>= 7; }
+        put((unsigned char)x);
+    }else{
+        char  tmp[12];
+        int   n = 0;
+        int   x = var(p) + 1;
+        if (sign(p)) put('-');
+        do { tmp[n++] = '0' + x % 10; x /= 10; } while (x > 0);
+        while (n > 0) put(tmp[--n]);
+        put(' ');
+    }
+}
+
+
+//=================================================================================================
+}
+
+#endif
@@ -1,14 +1,18 @@
 #include "src/utils/ExternalWatcher.h"
 #include "src/core/Solver.h"
 #include "src/core/SolverTypes.h"
+#include "src/utils/System.h"
 
 #include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <json/value.h>
 #include <minisat/core/SolverTypes.h>
+#include <fcntl.h>
+#include <signal.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #include <json/json.h>
 
@@ -18,7 +22,9 @@ ExternalWatcher::ExternalWatcher(Solver &S, const std::string &socket_path) :
     S(S),
     socket_path(socket_path),
     socket_id(socket(AF_UNIX, SOCK_STREAM, 0)),
-    stopping(false)
+    stopping(false),
+    speculation_results(Json::arrayValue),
+    speculation_poll(0)
 {
     if (socket_id < 0) {
         perror("socket");
@@ -48,6 +54,11 @@ ExternalWatcher::ExternalWatcher(Solver &S, const std::string &socket_path) :
 }
 
 ExternalWatcher::~ExternalWatcher() {
+    for (Speculation &spec : speculations) {
+        kill(spec.pid, SIGKILL);
+        waitpid(spec.pid, NULL, 0);
+        close(spec.fd);
+    }
     stopping = true;
     int client_socket = socket(AF_UNIX, SOCK_STREAM, 0);
     int conn = connect(client_socket, (struct sockaddr*)&addr, sizeof(addr));
@@ -116,6 +127,9 @@ void ExternalWatcher::notifyConflict(CRef confl, const vec<Lit>& learnt_clause)
 */
 bool ExternalWatcher::notifyDecision() {
     bool should_restart = false;
+    // finished speculations are only looked for once in a while (it costs a system call per child)
+    if (!speculations.empty() && (++speculation_poll & 1023) == 0)
+        collectSpeculations();
     std::unique_lock<std::mutex> lock(query_mutex);
     if (!instructions.empty()) {
         for (const Json::Value &instr : instructions)
@@ -162,6 +176,16 @@ std::string ExternalWatcher::exportData(CRef confl, const vec<Lit>& learnt_claus
         json_activity.append(S.activity[i]);
     root["activity"] = json_activity;
 
+    collectSpeculations();
+    if (!speculation_results.empty() || !speculations.empty()) {
+        Json::Value json_running(Json::arrayValue);
+        for (const Speculation &spec : speculations)
+            json_running.append(spec.index);
+        root["speculation_running"] = json_running;
+        root["speculation_results"] = speculation_results;
+        speculation_results = Json::Value(Json::arrayValue);
+    }
+
     if (S.best_clause != CRef_Undef) {
         const Clause &best_clause = S.ca[S.best_clause];
         Json::Value json_best_clause(Json::arrayValue);
@@ -246,6 +270,15 @@ bool ExternalWatcher::processInstruction(const Json::Value &instr) {
                 S.rebuildOrderHeap();
             }
         }
+        else if (key == "fork") {
+            if (!value.isArray()) {
+                std::cerr << "Instruction: Fork is not an array of instructions" << key << std::endl;
+                continue;
+            }
+            for (int i = 0; i < (int)value.size(); i++)
+                startSpeculation(value[i], i);
+        }
+        else if (key == "conflicts" || key == "model") ;  // settings of a speculation, see 'runSpeculation'
         else std::cerr << "Instruction: Unexpected Json key: " << key << std::endl;
     }
     return should_restart;
@@ -367,6 +400,11 @@ bool ExternalWatcher::addDefinition(const Json::Value &def_json) {
         std::vector<vec<Lit>> clauses = getDefClauses(def_json, sign);
         for (vec <Lit> &clause : clauses) {
             clause.push(mkLit(v, !sign));
+            if (S.proof.active()){
+                // The defining literal goes first, as it is the pivot of the RAT check:
+                std::swap(clause[0], clause.last());
+                S.proof.add(clause);
+            }
             // printf("Adding clause (%d):", clause.size());
             // for (int i = 0; i < clause.size(); i++)
             //     printf(" %d", toInt(clause[i]));
@@ -377,6 +415,123 @@ bool ExternalWatcher::addDefinition(const Json::Value &def_json) {
     return true;
 }
 
+/*
+  The "fork" instruction holds an array of instructions. For each of them, a child process is forked
+  that applies it to its copy of the solver and searches from the root level, reusing the learnt
+  clauses. Besides the usual keys, a variant may contain "conflicts" (a conflict budget) and "model"
+  (report the model if one is found). The parent continues its own search unchanged; the results of
+  the children are reported in "speculation_results" with the next exported data.
+*/
+void ExternalWatcher::startSpeculation(const Json::Value &variant, int index) {
+    if (!variant.isObject()) {
+        std::cerr << "Instruction: Fork variant is not a Json object: " << variant << std::endl;
+        return;
+    }
+    int fds[2];
+    if (pipe(fds) != 0) {
+        perror("pipe");
+        return;
+    }
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        close(fds[0]);
+        close(fds[1]);
+        return;
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        runSpeculation(variant, index, fds[1]);
+    }
+    close(fds[1]);
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+
+    Speculation spec;
+    spec.pid   = pid;
+    spec.fd    = fds[0];
+    spec.index = index;
+    speculations.push_back(spec);
+}
+
+void ExternalWatcher::runSpeculation(const Json::Value &variant, int index, int fd) {
+    // Only the solver thread exists in the child: detach everything that belongs to the threads
+    // of the parent (the watcher is never destroyed, the process ends with '_exit()')
+    S.external_watcher.release();
+    S.proof.abandon();
+    S.trace.abandon();
+    S.verbosity       = 0;
+    S.checkpoint_file = NULL;
+    close(socket_id);
+    for (int client_socket : client_sockets_received) close(client_socket);
+    for (int client_socket : client_sockets_ready) close(client_socket);
+    for (const Speculation &spec : speculations) close(spec.fd);
+
+    speculations.clear();
+
+    Json::Value settings = variant;
+    settings.removeMember("fork");  // (nobody would collect the results of nested speculations)
+    S.cancelUntil(0);
+    processInstruction(settings);
+    if (variant.isMember("conflicts") && variant["conflicts"].isConvertibleTo(Json::ValueType::intValue))
+        S.setConfBudget(variant["conflicts"].asInt64());
+
+    double  start_time = cpuTime();
+    uint64_t start_conflicts = S.conflicts;
+    lbool   res = S.ok ? S.solve_() : l_False;
+
+    Json::Value result;
+    result["index"]     = index;
+    result["pid"]       = (Json::Int)getpid();
+    result["result"]    = res == l_True ? "SAT" : res == l_False ? "UNSAT" : "INDET";
+    result["conflicts"] = (Json::UInt64)(S.conflicts - start_conflicts);
+    result["time"]      = cpuTime() - start_time;
+    if (res == l_True && variant.get("model", false).asBool()) {
+        Json::Value json_model(Json::arrayValue);
+        for (int i = 0; i < S.nVars(); i++)
+            json_model.append(S.model[i] == l_True ? i+1 : S.model[i] == l_False ? -(i+1) : 0);
+        result["model"] = json_model;
+    }
+
+    Json::FastWriter fastWriter;
+    std::string message = fastWriter.write(result);
+    for (size_t done = 0; done < message.size(); ) {
+        ssize_t n = write(fd, message.data() + done, message.size() - done);
+        if (n <= 0) break;
+        done += n;
+    }
+    _exit(0);
+}
+
+/*
+  Read the output of the children without blocking; a child is done when its pipe is closed.
+*/
+void ExternalWatcher::collectSpeculations() {
+    for (size_t i = 0; i < speculations.size(); ) {
+        Speculation &spec = speculations[i];
+        char buffer[4096];
+        ssize_t n;
+        while ((n = read(spec.fd, buffer, sizeof(buffer))) > 0)
+            spec.output.append(buffer, n);
+        if (n < 0) { i++; continue; }  // still running (EAGAIN)
+
+        waitpid(spec.pid, NULL, 0);
+        close(spec.fd);
+        Json::Value result;
+        Json::CharReaderBuilder builder;
+        std::string errs;
+        std::istringstream iss(spec.output);
+        if (!Json::parseFromStream(builder, iss, &result, &errs)) {
+            result = Json::Value(Json::objectValue);
+            result["index"]  = spec.index;
+            result["pid"]    = (Json::Int)spec.pid;
+            result["result"] = "FAILED";
+        }
+        speculation_results.append(result);
+        speculations.erase(speculations.begin() + i);
+    }
+}
+
 void ExternalWatcher::loadFileInstruction(const std::string &fname) {
     std::ifstream instr_file(fname);
     if (instr_file.is_open()) {
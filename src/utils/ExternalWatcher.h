@@ -5,6 +5,7 @@
 #include <thread>
 #include <mutex>
 #include <vector>
+#include <sys/types.h>
 #include <sys/un.h>
 
 #include "src/mtl/Vec.h"
@@ -36,6 +37,18 @@ private:
     bool addDefinition(const Json::Value &);
     bool processInstruction(const Json::Value &instr);  // returns whether the solver should restart
 
+    // Speculation: child processes forked at a decision continue from a copy-on-write snapshot of
+    // the solver with different settings, and report back through a pipe
+    struct Speculation {
+        pid_t       pid;
+        int         fd;        // reading end of the pipe
+        int         index;     // position of the variant in the "fork" instruction
+        std::string output;
+    };
+    void startSpeculation(const Json::Value &variant, int index);
+    void runSpeculation(const Json::Value &variant, int index, int fd);  // in the child, does not return
+    void collectSpeculations();
+
     bool                       stopping;
 
     Solver                     &S;
@@ -49,6 +62,9 @@ private:
     // sockets having their instructions applied, waiting for a conflict
     std::vector<int>           client_sockets_ready;
     std::vector<Json::Value>   instructions;
+    std::vector<Speculation>   speculations;
+    Json::Value                speculation_results;  // finished, not yet exported
+    unsigned                   speculation_poll;
 };
 
 } // namespace Minisat
@@ -0,0 +1,416 @@
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <zlib.h>
+#ifdef MINISAT_HAVE_BZIP2
+#include <bzlib.h>
+#endif
+#ifdef MINISAT_HAVE_LZMA
+#include <lzma.h>
+#endif
+#ifdef MINISAT_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "src/mtl/XAlloc.h"
+#include "src/utils/InputStream.h"
+
+using namespace Minisat;
+
+//=================================================================================================
+// Raw (compressed) bytes from a file descriptor:
+
+
+struct InputStream::Source {
+    enum { buffer_size = 256*1024 };
+
+    int            fd;
+    unsigned char* buf;
+    int            pos;
+    int            size;
+    bool           eof;
+
+    explicit Source(int fd_) : fd(fd_), pos(0), size(0), eof(false) {
+        buf = (unsigned char*)xrealloc(NULL, buffer_size); }
+    ~Source() { free(buf); if (fd >= 0) ::close(fd); }
+
+    int  avail() const { return size - pos; }
+
+    // Reads more input if the buffer is exhausted. Returns FALSE at the end of the input.
+    bool refill() {
+        if (pos < size) return true;
+        pos = size = 0;
+        while (!eof){
+            ssize_t n = ::read(fd, buf, buffer_size);
+            if (n > 0)  { size = (int)n; return true; }
+            if (n == 0) eof = true;
+            else if (errno != EINTR) eof = true;
+        }
+        return false; }
+
+    // Makes sure at least 'n' bytes are buffered (if the input is that long), for format detection.
+    void lookahead(int n) {
+        while (size < n && !eof){
+            ssize_t r = ::read(fd, buf + size, buffer_size - size);
+            if (r > 0)  size += (int)r;
+            else if (r == 0 || errno != EINTR) eof = true; } }
+};
+
+
+//=================================================================================================
+// Decoders:
+
+
+class InputStream::Decoder {
+public:
+    virtual ~Decoder() {}
+    // Decodes up to 'size' bytes into 'out'. Returns the number of bytes produced, 0 at the end of
+    // the input, or -1 on error.
+    virtual int decode(Source& in, unsigned char* out, int size) = 0;
+};
+
+
+namespace {
+
+class PlainDecoder : public InputStream::Decoder {
+public:
+    int decode(InputStream::Source& in, unsigned char* out, int size) {
+        if (!in.refill()) return 0;
+        int n = in.avail() < size ? in.avail() : size;
+        memcpy(out, in.buf + in.pos, n);
+        in.pos += n;
+        return n; }
+};
+
+
+class GzipDecoder : public InputStream::Decoder {
+    z_stream z;
+    bool     ok;
+    bool     done;
+public:
+    GzipDecoder() : done(false) {
+        memset(&z, 0, sizeof(z));
+        ok = inflateInit2(&z, 15 + 16) == Z_OK; }
+    ~GzipDecoder() { inflateEnd(&z); }
+
+    int decode(InputStream::Source& in, unsigned char* out, int size) {
+        if (!ok)  return -1;
+        if (done) return 0;
+        z.next_out  = out;
+        z.avail_out = size;
+        while (z.avail_out == (uInt)size){
+            if (!in.refill()) return -1; // Input ended inside a member.
+            z.next_in  = in.buf + in.pos;
+            z.avail_in = in.avail();
+            int ret = inflate(&z, Z_NO_FLUSH);
+            in.pos = in.size - z.avail_in;
+            if (ret == Z_STREAM_END){
+                // Concatenated members are decoded as one stream, anything else following the
+                // last member is ignored (like 'gzread()'):
+                if (!in.refill() || in.buf[in.pos] != 0x1f){
+                    done = true;
+                    break; }
+                if (inflateReset(&z) != Z_OK) return -1;
+            }else if (ret != Z_OK)
+                return -1;
+        }
+        return size - z.avail_out; }
+};
+
+
+#ifdef MINISAT_HAVE_BZIP2
+class Bzip2Decoder : public InputStream::Decoder {
+    bz_stream b;
+    bool      ok;
+    bool      done;
+public:
+    Bzip2Decoder() : done(false) {
+        memset(&b, 0, sizeof(b));
+        ok = BZ2_bzDecompressInit(&b, 0, 0) == BZ_OK; }
+    ~Bzip2Decoder() { if (ok) BZ2_bzDecompressEnd(&b); }
+
+    int decode(InputStream::Source& in, unsigned char* out, int size) {
+        if (!ok)  return -1;
+        if (done) return 0;
+        b.next_out  = (char*)out;
+        b.avail_out = size;
+        while (b.avail_out == (unsigned)size){
+            if (!in.refill()) return -1; // Input ended inside a stream.
+            b.next_in  = (char*)in.buf + in.pos;
+            b.avail_in = in.avail();
+            int ret = BZ2_bzDecompress(&b);
+            in.pos = in.size - b.avail_in;
+            if (ret == BZ_STREAM_END){
+                // Restart for concatenated streams (as produced by e.g. 'pbzip2'):
+                if (!in.refill() || in.buf[in.pos] != 'B'){
+                    done = true;
+                    break; }
+                BZ2_bzDecompressEnd(&b);
+                if (!(ok = BZ2_bzDecompressInit(&b, 0, 0) == BZ_OK)) return -1;
+            }else if (ret != BZ_OK)
+                return -1;
+        }
+        return size - b.avail_out; }
+};
+#endif
+
+
+#ifdef MINISAT_HAVE_LZMA
+class XzDecoder : public InputStream::Decoder {
+    lzma_stream s;
+    bool        ok;
+    bool        done;
+public:
+    XzDecoder() : done(false) {
+        lzma_stream init = LZMA_STREAM_INIT;
+        s  = init;
+        ok = lzma_stream_decoder(&s, UINT64_MAX, LZMA_CONCATENATED) == LZMA_OK; }
+    ~XzDecoder() { lzma_end(&s); }
+
+    int decode(InputStream::Source& in, unsigned char* out, int size) {
+        if (!ok)  return -1;
+        if (done) return 0;
+        s.next_out  = out;
+        s.avail_out = size;
+        while (s.avail_out == (size_t)size){
+            bool more  = in.refill();
+            s.next_in  = in.buf + in.pos;
+            s.avail_in = in.avail();
+            lzma_ret ret = lzma_code(&s, more ? LZMA_RUN : LZMA_FINISH);
+            in.pos = in.size - (int)s.avail_in;
+            if (ret == LZMA_STREAM_END){
+                done = true;
+                break; }
+            if (ret != LZMA_OK) return -1;
+            if (!more && s.avail_out == (size_t)size) return -1; // Truncated input.
+        }
+        return size - (int)s.avail_out; }
+};
+#endif
+
+
+#ifdef MINISAT_HAVE_ZSTD
+class ZstdDecoder : public InputStream::Decoder {
+    ZSTD_DStream* d;
+    size_t        last;  // Last return value of 'ZSTD_decompressStream()'; 0 when a frame is complete.
+public:
+    ZstdDecoder() : d(ZSTD_createDStream()), last(0) { if (d != NULL) ZSTD_initDStream(d); }
+    ~ZstdDecoder() { ZSTD_freeDStream(d); }
+
+    int decode(InputStream::Source& in, unsigned char* out, int size) {
+        if (d == NULL) return -1;
+        ZSTD_outBuffer o = { out, (size_t)size, 0 };
+        while (o.pos == 0){
+            if (!in.refill())
+                return last == 0 ? 0 : -1; // Input must end at a frame boundary.
+            ZSTD_inBuffer i = { in.buf + in.pos, (size_t)in.avail(), 0 };
+            last = ZSTD_decompressStream(d, &o, &i);
+            in.pos += (int)i.pos;
+            if (ZSTD_isError(last)) return -1;
+        }
+        return (int)o.pos; }
+};
+#endif
+
+}
+
+
+//=================================================================================================
+// InputStream:
+
+
+InputStream::Format InputStream::detectFormat(const unsigned char* data, uint64_t size)
+{
+    if (size >= 2 && data[0] == 0x1f && data[1] == 0x8b)
+        return fmt_gzip;
+    if (size >= 3 && data[0] == 'B' && data[1] == 'Z' && data[2] == 'h')
+        return fmt_bzip2;
+    if (size >= 6 && memcmp(data, "\xFD" "7zXZ\0", 6) == 0)
+        return fmt_xz;
+    if (size >= 4 && data[0] == 0x28 && data[1] == 0xB5 && data[2] == 0x2F && data[3] == 0xFD)
+        return fmt_zstd;
+    return fmt_plain;
+}
+
+
+const char* InputStream::formatName(Format f)
+{
+    switch (f){
+    case fmt_gzip:  return "gzip";
+    case fmt_bzip2: return "bzip2";
+    case fmt_xz:    return "xz";
+    case fmt_zstd:  return "zstd";
+    default:        return "plain";
+    }
+}
+
+
+bool InputStream::supported(Format f)
+{
+    switch (f){
+#ifndef MINISAT_HAVE_BZIP2
+    case fmt_bzip2: return false;
+#endif
+#ifndef MINISAT_HAVE_LZMA
+    case fmt_xz:    return false;
+#endif
+#ifndef MINISAT_HAVE_ZSTD
+    case fmt_zstd:  return false;
+#endif
+    default:        return true;
+    }
+}
+
+
+InputStream::InputStream() :
+    src(NULL), dec(NULL), fmt(fmt_plain), threaded(false), cur(0), cur_valid(false), cur_pos(0),
+    at_end(false), failed(false), stopping(false)
+{
+    block[0] = block[1] = NULL;
+    block_len[0] = block_len[1] = 0;
+    block_full[0] = block_full[1] = false;
+}
+
+
+bool InputStream::open(const char* path, bool threaded_)
+{
+    int fd = ::open(path, O_RDONLY);
+    return fd >= 0 && open(fd, threaded_);
+}
+
+
+bool InputStream::open(int fd, bool threaded_)
+{
+    close();
+    src = new Source(fd);
+    src->lookahead(6);
+    fmt = detectFormat(src->buf, src->size);
+    if (!supported(fmt))
+        fprintf(stderr, "ERROR! Input is %s-compressed, but this build has no %s support.\n", formatName(fmt), formatName(fmt)), exit(1);
+
+    switch (fmt){
+    case fmt_gzip:  dec = new GzipDecoder();  break;
+#ifdef MINISAT_HAVE_BZIP2
+    case fmt_bzip2: dec = new Bzip2Decoder(); break;
+#endif
+#ifdef MINISAT_HAVE_LZMA
+    case fmt_xz:    dec = new XzDecoder();    break;
+#endif
+#ifdef MINISAT_HAVE_ZSTD
+    case fmt_zstd:  dec = new ZstdDecoder();  break;
+#endif
+    default:        dec = new PlainDecoder(); break;
+    }
+
+    threaded = threaded_;
+    if (threaded){
+        for (int i = 0; i < 2; i++){
+            block[i]      = (unsigned char*)xrealloc(NULL, block_size);
+            block_len[i]  = 0;
+            block_full[i] = false; }
+        cur = cur_pos = 0;
+        cur_valid = false;
+        at_end = failed = stopping = false;
+        worker = std::thread(&InputStream::workerLoop, this);
+    }
+    return true;
+}
+
+
+void InputStream::close()
+{
+    if (worker.joinable()){
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+    for (int i = 0; i < 2; i++){
+        free(block[i]);
+        block[i] = NULL; }
+    delete dec; dec = NULL;
+    delete src; src = NULL;
+}
+
+
+void InputStream::fail()
+{
+    fprintf(stderr, "ERROR! Corrupt or truncated %s input.\n", formatName(fmt));
+    exit(1);
+}
+
+
+int InputStream::fill(unsigned char* buf, int size)
+{
+    int len = 0;
+    while (len < size){
+        int n = dec->decode(*src, buf + len, size - len);
+        if (n < 0)  return -1;
+        if (n == 0) break;
+        len += n; }
+    return len;
+}
+
+
+void InputStream::workerLoop()
+{
+    for (int i = 0;; i ^= 1){
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [&]{ return stopping || !block_full[i]; });
+            if (stopping) return;
+        }
+
+        int len = fill(block[i], block_size);
+
+        std::lock_guard<std::mutex> lock(mtx);
+        if (len < 0)
+            failed = true;
+        else{
+            block_len[i]  = len;
+            block_full[i] = len > 0;
+            at_end        = len < block_size; }
+        cv.notify_all();
+        if (failed || at_end) return;
+    }
+}
+
+
+int InputStream::read(unsigned char* buf, int size)
+{
+    if (dec == NULL) return 0;
+
+    if (!threaded){
+        int len = fill(buf, size);
+        if (len < 0) fail();
+        return len; }
+
+    if (!cur_valid || cur_pos == block_len[cur]){
+        std::unique_lock<std::mutex> lock(mtx);
+        if (cur_valid){
+            // Hand the consumed block back to the producer and move on to the other one:
+            block_full[cur] = false;
+            cur_valid       = false;
+            cur            ^= 1;
+            cur_pos         = 0;
+            cv.notify_all();
+        }
+        cv.wait(lock, [&]{ return block_full[cur] || at_end || failed; });
+        if (!block_full[cur]){
+            if (failed) fail();
+            return 0; }
+        cur_valid = true;
+    }
+
+    int n = block_len[cur] - cur_pos;
+    if (n > size) n = size;
+    memcpy(buf, block[cur] + cur_pos, n);
+    cur_pos += n;
+    return n;
+}
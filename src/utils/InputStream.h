@@ -0,0 +1,82 @@
+#ifndef Minisat_InputStream_h
+#define Minisat_InputStream_h
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "src/mtl/IntTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Byte input with transparent decompression:
+//
+// The compression format is detected from the magic bytes at the start of the input. Formats other
+// than plain and gzip are only available if the corresponding library was found at build time
+// (MINISAT_HAVE_BZIP2, MINISAT_HAVE_LZMA, MINISAT_HAVE_ZSTD). When opened as 'threaded', reading
+// and decompressing happen on a background thread that fills one buffer while the other one is
+// being consumed.
+
+
+class InputStream {
+public:
+    enum Format { fmt_plain, fmt_gzip, fmt_bzip2, fmt_xz, fmt_zstd };
+
+    static Format      detectFormat(const unsigned char* data, uint64_t size);
+    static const char* formatName  (Format f);
+    static bool        supported   (Format f);
+
+    InputStream();
+    ~InputStream() { close(); }
+
+    bool   open  (const char* path, bool threaded = true); // FALSE if the file could not be opened.
+    bool   open  (int fd, bool threaded = true);           // Takes ownership of 'fd'.
+    void   close ();
+
+    // Reads up to 'size' decompressed bytes into 'buf'. Returns 0 at the end of the input. Corrupt
+    // input or an unsupported format is reported on stderr and terminates the program.
+    int    read  (unsigned char* buf, int size);
+
+    Format format() const { return fmt; }
+
+    // Implementation details (defined in 'InputStream.cc'):
+    struct Source;
+    class  Decoder;
+
+private:
+    enum { block_size = 1024*1024 };
+
+    Source*                 src;
+    Decoder*                dec;
+    Format                  fmt;
+
+    // Background decompression (double buffer):
+    bool                    threaded;
+    std::thread             worker;
+    std::mutex              mtx;
+    std::condition_variable cv;
+    unsigned char*          block     [2];
+    int                     block_len [2];
+    bool                    block_full[2];
+    int                     cur;       // Block currently being consumed.
+    bool                    cur_valid; // Consumer owns 'block[cur]'.
+    int                     cur_pos;   // Read position within 'block[cur]'.
+    bool                    at_end;    // Producer reached the end of the input.
+    bool                    failed;    // Producer hit a decoding error.
+    bool                    stopping;
+
+    int  fill      (unsigned char* buf, int size); // Decode until 'buf' is full or the input ends; -1 on error.
+    void workerLoop();
+    void fail      ();
+
+    // Don't allow copying:
+    InputStream(const InputStream&);
+    InputStream& operator=(const InputStream&);
+};
+
+
+//=================================================================================================
+}
+
+#endif
@@ -0,0 +1,51 @@
+#include <stdio.h>
+
+#include "src/utils/MappedFile.h"
+
+#if defined(_MSC_VER) || defined(__MINGW32__)
+
+// Memory mapping is not supported on this platform; callers fall back to buffered reading.
+bool Minisat::MappedFile::open(const char*) { return false; }
+void Minisat::MappedFile::close() {}
+
+#else
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace Minisat;
+
+bool MappedFile::open(const char* path)
+{
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0){
+        ::close(fd);
+        return false; }
+
+    void* mem = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mem == MAP_FAILED) return false;
+
+    madvise(mem, (size_t)st.st_size, MADV_SEQUENTIAL);
+    data_ = (const char*)mem;
+    size_ = (uint64_t)st.st_size;
+    return true;
+}
+
+
+void MappedFile::close()
+{
+    if (data_ != NULL)
+        munmap((void*)data_, (size_t)size_);
+    data_ = NULL;
+    size_ = 0;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef Minisat_MappedFile_h
+#define Minisat_MappedFile_h
+
+#include "src/mtl/IntTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// A read-only memory mapping of a whole file:
+
+
+class MappedFile {
+    const char* data_;
+    uint64_t    size_;
+
+    // Don't allow copying:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+public:
+    MappedFile() : data_(NULL), size_(0) {}
+    ~MappedFile() { close(); }
+
+    bool        open (const char* path); // FALSE if the file could not be mapped (not a regular file, empty, ...).
+    void        close();
+
+    const char* data () const { return data_; }
+    uint64_t    size () const { return size_; }
+};
+
+
+//=================================================================================================
+}
+
+#endif
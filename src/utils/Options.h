@@ -368,7 +368,8 @@ class BoolOption : public Option
 
         fprintf(stderr, "  -%s, -no-%s", name, name);
 
-        for (uint32_t i = 0; i < 32 - strlen(name)*2; i++)
+        int pad = 32 - 2*(int)strlen(name);
+        for (int i = 0; i < pad; i++)
             fprintf(stderr, " ");
 
         fprintf(stderr, " ");
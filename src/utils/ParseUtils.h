@@ -27,6 +27,7 @@ OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWA
 #include <zlib.h>
 
 #include "src/mtl/XAlloc.h"
+#include "src/utils/InputStream.h"
 
 namespace Minisat {
 
@@ -37,6 +38,7 @@ namespace Minisat {
 
 class StreamBuffer {
     gzFile         in;
+    InputStream*   stream;
     unsigned char* buf;
     int            pos;
     int            size;
@@ -46,10 +48,14 @@ class StreamBuffer {
     void assureLookahead() {
         if (pos >= size) {
             pos  = 0;
-            size = gzread(in, buf, buffer_size); } }
+            size = stream != NULL ? stream->read(buf, buffer_size) : gzread(in, buf, buffer_size); } }
 
 public:
-    explicit StreamBuffer(gzFile i) : in(i), pos(0), size(0){
+    explicit StreamBuffer(gzFile i) : in(i), stream(NULL), pos(0), size(0){
+        buf = (unsigned char*)xrealloc(NULL, buffer_size);
+        assureLookahead();
+    }
+    explicit StreamBuffer(InputStream& i) : in(NULL), stream(&i), pos(0), size(0){
         buf = (unsigned char*)xrealloc(NULL, buffer_size);
         assureLookahead();
     }
@@ -58,6 +64,11 @@ public:
     int  operator *  () const { return (pos >= size) ? EOF : buf[pos]; }
     void operator ++ ()       { pos++; assureLookahead(); }
     int  position    () const { return pos; }
+
+    // Direct access to the buffered characters, for scanning several of them without a refill
+    // check per character. 'peek(avail)[0 .. avail-1]' are valid; 'skip(n)' consumes 'n <= avail'.
+    const unsigned char* peek(int& avail) const { avail = size - pos; return buf + pos; }
+    void                 skip(int n)            { pos += n; assureLookahead(); }
 };
 
 
@@ -100,6 +111,25 @@ static int parseInt(B& in) {
     return neg ? -val : val; }
 
 
+// Pointer-based variant of 'parseInt()' for scanning a buffered block '[p, end)'. Returns the
+// position after the integer, or NULL if the integer is not known to be complete before 'end'
+// (the caller then has to continue with the stream-based version).
+static inline const unsigned char* scanInt(const unsigned char* p, const unsigned char* end, int& val) {
+    while (p < end && ((*p >= 9 && *p <= 13) || *p == 32)) p++;
+    if (p == end) return NULL;
+    bool neg = false;
+    if      (*p == '-') neg = true, p++;
+    else if (*p == '+') p++;
+    if (p == end) return NULL;
+    if (*p < '0' || *p > '9') fprintf(stderr, "PARSE ERROR! Unexpected char: %c\n", *p), exit(3);
+    int v = 0;
+    while (p < end && (unsigned)(*p - '0') < 10)
+        v = v*10 + (*p++ - '0');
+    if (p == end) return NULL;
+    val = neg ? -v : v;
+    return p; }
+
+
 // String matching: in case of a match the input iterator will be advanced the corresponding
 // number of characters.
 template<class B>
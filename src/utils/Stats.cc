@@ -0,0 +1,95 @@
+#include "src/utils/Stats.h"
+
+using namespace Minisat;
+
+
+void SolverStats::add(const char* name, uint64_t value)
+{
+    Entry e;
+    e.name     = name;
+    e.integral = true;
+    e.n        = value;
+    e.x        = 0;
+    entries.push_back(e);
+}
+
+
+void SolverStats::add(const char* name, double value)
+{
+    Entry e;
+    e.name     = name;
+    e.integral = false;
+    e.n        = 0;
+    e.x        = value;
+    entries.push_back(e);
+}
+
+
+void SolverStats::add(const char* name, const PhaseTime& t)
+{
+    std::string prefix = name;
+    add((prefix + ".calls").c_str(), t.calls);
+    add((prefix + ".wall").c_str(), t.wall);
+    add((prefix + ".cpu").c_str(), t.cpu);
+}
+
+
+int SolverStats::find(const char* name) const
+{
+    for (int i = 0; i < size(); i++)
+        if (entries[i].name == name)
+            return i;
+    return -1;
+}
+
+
+Json::Value SolverStats::toJson() const
+{
+    Json::Value root(Json::objectValue);
+    for (const Entry& e : entries){
+        // Walk down (and create) the objects along the dots of the name:
+        Json::Value* obj  = &root;
+        size_t       from = 0, dot;
+        while ((dot = e.name.find('.', from)) != std::string::npos){
+            obj  = &(*obj)[e.name.substr(from, dot - from)];
+            from = dot + 1; }
+        if (e.integral) (*obj)[e.name.substr(from)] = Json::UInt64(e.n);
+        else            (*obj)[e.name.substr(from)] = e.x;
+    }
+    return root;
+}
+
+
+static bool writeString(const char* path, const std::string& text)
+{
+    FILE* out = fopen(path, "w");
+    if (out == NULL) return false;
+    bool ok = fwrite(text.data(), 1, text.size(), out) == text.size();
+    return (fclose(out) == 0) && ok;
+}
+
+
+bool SolverStats::writeJson(const char* path) const
+{
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "  ";
+    return writeString(path, Json::writeString(builder, toJson()) + "\n");
+}
+
+
+bool SolverStats::writeCsv(const char* path) const
+{
+    std::string text;
+    for (int i = 0; i < size(); i++){
+        if (i > 0) text += ',';
+        text += entries[i].name; }
+    text += '\n';
+    for (int i = 0; i < size(); i++){
+        char buf[32];
+        if (entries[i].integral) snprintf(buf, sizeof(buf), "%" PRIu64, entries[i].n);
+        else                     snprintf(buf, sizeof(buf), "%.9g", entries[i].x);
+        if (i > 0) text += ',';
+        text += buf; }
+    text += '\n';
+    return writeString(path, text);
+}
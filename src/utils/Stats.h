@@ -0,0 +1,92 @@
+#ifndef Minisat_Stats_h
+#define Minisat_Stats_h
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <json/json.h>
+
+#include "src/mtl/IntTypes.h"
+#include "src/utils/System.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Phase timers:
+//
+// A 'PhaseTimer' on the stack adds the wall-clock time of its scope to a 'PhaseTime'. The CPU time
+// of the thread is only measured on request, as reading it is a system call (several times slower
+// than the wall clock); it is meant for the coarse phases. A timer that is not armed costs a test.
+
+
+struct PhaseTime {
+    uint64_t calls;
+    double   wall;     // Seconds.
+    double   cpu;      // Seconds (0 unless measured).
+    PhaseTime() : calls(0), wall(0), cpu(0) {}
+};
+
+
+class PhaseTimer {
+    PhaseTime* t;
+    double     wall0;
+    double     cpu0;
+
+    // Don't allow copying:
+    PhaseTimer(const PhaseTimer&);
+    PhaseTimer& operator=(const PhaseTimer&);
+
+public:
+    PhaseTimer(PhaseTime& time, bool armed, bool with_cpu = false) : t(armed ? &time : NULL), wall0(0), cpu0(-1) {
+        if (t == NULL) return;
+        if (with_cpu) cpu0 = threadCpuTime();
+        wall0 = wallTime(); }
+
+    ~PhaseTimer() {
+        if (t == NULL) return;
+        t->calls++;
+        t->wall += wallTime() - wall0;
+        if (cpu0 >= 0) t->cpu += threadCpuTime() - cpu0; }
+};
+
+
+//=================================================================================================
+// SolverStats -- a snapshot of named statistics (see 'Solver::collectStats()'):
+//
+// Names are dotted paths such as "search.conflicts" or "time.propagate.wall", kept in the order
+// they were added. The JSON export nests the objects along the dots; the CSV export is a header line
+// with the names and a line with the values, so the files of several runs are easy to concatenate.
+
+
+class SolverStats {
+public:
+    void add(const char* name, uint64_t value);
+    void add(const char* name, double value);
+    void add(const char* name, const PhaseTime& t);   // As "<name>.calls", "<name>.wall" and "<name>.cpu".
+    void clear() { entries.clear(); }
+
+    int         size   ()      const { return (int)entries.size(); }
+    const char* name   (int i) const { return entries[i].name.c_str(); }
+    double      value  (int i) const { return entries[i].integral ? (double)entries[i].n : entries[i].x; }
+    int         find   (const char* name) const;     // Index of 'name' (or -1).
+    double      get    (const char* name, double def = 0) const { int i = find(name); return i < 0 ? def : value(i); }
+
+    Json::Value toJson   () const;
+    bool        writeJson(const char* path) const;   // FALSE if the file could not be written.
+    bool        writeCsv (const char* path) const;
+
+private:
+    struct Entry {
+        std::string name;
+        bool        integral;
+        uint64_t    n;
+        double      x;
+    };
+    std::vector<Entry> entries;
+};
+
+
+//=================================================================================================
+}
+
+#endif
@@ -167,3 +167,27 @@ void Minisat::sigTerm(void handler(int))
     signal(SIGXCPU,handler);
 #endif
 }
+
+
+#if !defined(_MSC_VER) && !defined(__MINGW32__)
+#include <sys/time.h>
+
+void Minisat::sigCheckpoint(void handler(int), uint32_t interval)
+{
+    signal(SIGUSR1, handler);
+    if (interval > 0){
+        signal(SIGALRM, handler);
+        struct itimerval timer;
+        timer.it_interval.tv_sec  = interval;
+        timer.it_interval.tv_usec = 0;
+        timer.it_value            = timer.it_interval;
+        if (setitimer(ITIMER_REAL, &timer, NULL) != 0)
+            printf("WARNING! Could not set up the checkpoint timer.\n");
+    }
+}
+#else
+void Minisat::sigCheckpoint(void /*handler*/(int), uint32_t /*interval*/)
+{
+    printf("WARNING! Checkpoint signals not supported on this architecture.\n");
+}
+#endif
@@ -0,0 +1,72 @@
+#include <stdlib.h>
+#include <chrono>
+
+#include "src/mtl/XAlloc.h"
+#include "src/utils/Trace.h"
+
+using namespace Minisat;
+
+
+TraceWriter::TraceWriter() :
+    out(NULL), failed(false), ring(NULL), head(0), tail(0), tail_seen(0), stopping(false)
+{}
+
+
+bool TraceWriter::open(const char* path)
+{
+    close();
+    if ((out = fopen(path, "wb")) == NULL)
+        return false;
+
+    failed    = fwrite(trace_magic, 1, sizeof(trace_magic), out) != sizeof(trace_magic);
+    ring      = (TraceRecord*)xrealloc(NULL, capacity * sizeof(TraceRecord));
+    head      = 0;
+    tail      = 0;
+    tail_seen = 0;
+    stopping  = false;
+    writer    = std::thread(&TraceWriter::writerLoop, this);
+    return true;
+}
+
+
+bool TraceWriter::close()
+{
+    if (out == NULL) return true;
+
+    stopping.store(true);
+    writer.join();
+
+    if (fclose(out) != 0) failed = true;
+    out = NULL;
+    free(ring); ring = NULL;
+    return !failed;
+}
+
+
+void TraceWriter::waitForRoom(uint64_t h)
+{
+    while (h - (tail_seen = tail.load(std::memory_order_acquire)) >= capacity)
+        std::this_thread::yield();
+}
+
+
+void TraceWriter::writerLoop()
+{
+    for (;;){
+        // ('stopping' is read first, so the records produced before 'close()' are all seen below)
+        bool     stop = stopping.load();
+        uint64_t t    = tail.load(std::memory_order_relaxed);
+        uint64_t h    = head.load(std::memory_order_acquire);
+        if (t == h){
+            if (stop) return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue; }
+
+        // Write the records up to the end of the ring, the rest in the next round:
+        uint64_t from = t & (capacity - 1);
+        uint64_t n    = h - t < capacity - from ? h - t : capacity - from;
+        if (fwrite(&ring[from], sizeof(TraceRecord), n, out) != n)
+            failed = true;
+        tail.store(t + n, std::memory_order_release);
+    }
+}
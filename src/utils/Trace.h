@@ -0,0 +1,105 @@
+#ifndef Minisat_Trace_h
+#define Minisat_Trace_h
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+
+#include "src/mtl/IntTypes.h"
+
+namespace Minisat {
+
+//=================================================================================================
+// Search event trace:
+//
+// When compiled with MINISAT_TRACE (cmake -DTRACE=ON), the solver records its decisions, conflicts,
+// restarts and clause database reductions into an open 'TraceWriter'. Otherwise 'TRACE_EVENT()'
+// expands to nothing and its arguments are not evaluated.
+//
+// Records have a fixed size. Each solver owns its writer. The solver thread puts records into a
+// ring buffer without locks; a background thread copies them to the file. The solver only waits if
+// the buffer is full, i.e. if it produces events faster than they can be written.
+//
+// File format: the 8 bytes "MSATTRC1" followed by the records (in the byte order of the machine).
+
+
+#ifdef MINISAT_TRACE
+#define TRACE_EVENT(writer, ...) (writer).record(__VA_ARGS__)
+#else
+#define TRACE_EVENT(writer, ...) ((void)0)
+#endif
+
+
+enum TraceKind {
+    trace_decision = 1,   // a: the decision ('toInt(Lit)')
+    trace_conflict = 2,   // a: size of the learnt clause, b: its LBD, c: the backjump level
+    trace_restart  = 3,   // a: number of the restart ('starts')
+    trace_reduce   = 4,   // a: learnt clauses removed, b: learnt clauses kept
+    trace_solve    = 5    // a: result ('toInt(lbool)'), b: number of assumptions (at the end of a 'solve()')
+};
+
+
+struct TraceRecord {
+    uint32_t kind;
+    uint32_t level;       // Decision level at the event (before backjumping for a conflict).
+    uint64_t conflicts;   // Conflicts so far: the time axis of the trace.
+    uint32_t a, b, c;
+    uint32_t pad;
+};
+
+
+static const char trace_magic[8] = { 'M', 'S', 'A', 'T', 'T', 'R', 'C', '1' };
+
+
+class TraceWriter {
+public:
+    TraceWriter();
+    ~TraceWriter() { close(); }
+
+    bool open   (const char* path);                // FALSE if the file could not be opened.
+    bool close  ();                                // Write out everything. FALSE on write errors.
+    bool active () const { return out != NULL; }
+    void abandon()       { out = NULL; }           // Stop recording without writing anything (in a forked child,
+                                                   // where the writer thread does not exist).
+
+    void record(uint32_t kind, uint32_t level, uint64_t conflicts, uint32_t a, uint32_t b = 0, uint32_t c = 0) {
+        if (out == NULL) return;
+        uint64_t h = head.load(std::memory_order_relaxed);
+        if (h - tail_seen >= capacity)
+            waitForRoom(h);
+        TraceRecord& r = ring[h & (capacity - 1)];
+        r.kind      = kind;
+        r.level     = level;
+        r.conflicts = conflicts;
+        r.a         = a;
+        r.b         = b;
+        r.c         = c;
+        r.pad       = 0;
+        head.store(h + 1, std::memory_order_release);
+    }
+
+private:
+    enum { capacity = 1 << 16 };                   // Records in the ring (a power of two).
+
+    FILE*                 out;
+    bool                  failed;
+    TraceRecord*          ring;
+    std::atomic<uint64_t> head;                    // Records produced (written only by the solver thread).
+    std::atomic<uint64_t> tail;                    // Records written out (written only by the writer thread).
+    uint64_t              tail_seen;               // The solver thread's last look at 'tail'.
+    std::atomic<bool>     stopping;
+    std::thread           writer;
+
+    void waitForRoom(uint64_t h);
+    void writerLoop();
+
+    // Don't allow copying:
+    TraceWriter(const TraceWriter&);
+    TraceWriter& operator=(const TraceWriter&);
+};
+
+
+//=================================================================================================
+}
+
+#endif